@@ -3,14 +3,21 @@
 #include "EnemyBase.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
-#include "ConstructorHelpers.h"
+#include "Engine/StaticMesh.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundCue.h"
+#include "Sound/SoundWave.h"
+#include "Sound/SoundNodeWavePlayer.h"
+#include "AudioDevice.h"
 #include "GeoGameState.h"
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Geo.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "SillyGeoGameMode.h"
-#include "GeoPlayerState.h"
+#include "SillyGeo.h"
+#include "SillyGeoStats.h"
 
 // Sets default values
 AEnemyBase::AEnemyBase()
@@ -32,32 +39,13 @@ AEnemyBase::AEnemyBase()
 	EnemyMesh->SetRelativeLocation(FVector(0.f, 0.f, HitSphere->GetScaledSphereRadius() / -2.f));
 	EnemyMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
-	/** set mesh */
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> EnemyMeshTempalte(TEXT("/Game/Shapes/Shape_Cone"));
-	if (EnemyMeshTempalte.Succeeded())
+	/** default assets, soft references, so they are streamed in with the map instead of loading with the class */
+	EnemyMeshAsset = FSoftObjectPath(TEXT("/Game/Shapes/Shape_Cone.Shape_Cone"));
+	EnemyMaterialAsset = FSoftObjectPath(TEXT("/Game/Enemies/Materials/MI_RedEnemy_Pulse.MI_RedEnemy_Pulse"));
+	if (!ShouldStripCosmetics())
 	{
-		EnemyMesh->SetStaticMesh(EnemyMeshTempalte.Object);
-	}
-
-	/** set mesh material */
-	static ConstructorHelpers::FObjectFinder<UMaterialInterface> MaterialTempalte(TEXT("/Game/Enemies/Materials/MI_RedEnemy_Pulse"));
-	if (MaterialTempalte.Succeeded())
-	{
-		EnemyMesh->SetMaterial(0, MaterialTempalte.Object);
-	}
-
-	/** set emitter template */
-	static ConstructorHelpers::FObjectFinder<UParticleSystem> ExplosionEmitterTempalte(TEXT("/Game/Enemies/Particles/PFX_EnemyExplosion"));
-	if (ExplosionEmitterTempalte.Succeeded())
-	{
-		ExplosionEmitter = ExplosionEmitterTempalte.Object;
-	}
-
-	/** set explosion sound  */
-	static ConstructorHelpers::FObjectFinder<USoundBase> ExplosionSoundTemplate(TEXT("/Game/Player/Audio/FlashImpact_Cue"));
-	if (ExplosionSoundTemplate.Succeeded())
-	{
-		ExplosionSound = ExplosionSoundTemplate.Object;
+		ExplosionEmitterAsset = FSoftObjectPath(TEXT("/Game/Enemies/Particles/PFX_EnemyExplosion.PFX_EnemyExplosion"));
+		ExplosionSoundAsset = FSoftObjectPath(TEXT("/Game/Player/Audio/FlashImpact_Cue.FlashImpact_Cue"));
 	}
 
 	/* enemy movement  */
@@ -73,23 +61,101 @@ AEnemyBase::AEnemyBase()
 	/** class defaults  */
 	bSpinning = false;
 	bRandomShift = false;
+	bNetProxy = false;
+	bNetSimulated = false;
+	bWarmUp = false;
+	bQualityPulse = true;
+	bLowSignificance = false;
 	SpawnCollisionHandlingMethod = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
 }
 
+void AEnemyBase::OnConstruction(const FTransform& Transform)
+{
+	/** loaded already if the game mode has preloaded them, otherwise loaded right now */
+	if (!EnemyMesh->GetStaticMesh())
+	{
+		EnemyMesh->SetStaticMesh(EnemyMeshAsset.LoadSynchronous());
+	}
+	if (EnemyMesh->GetNumOverrideMaterials() == 0)
+	{
+		EnemyMesh->SetMaterial(0, EnemyMaterialAsset.LoadSynchronous());
+	}
+	if (!ExplosionEmitter && !ShouldStripCosmetics())
+	{
+		ExplosionEmitter = ExplosionEmitterAsset.LoadSynchronous();
+	}
+	if (!ExplosionSound && !ShouldStripCosmetics())
+	{
+		ExplosionSound = ExplosionSoundAsset.LoadSynchronous();
+	}
+
+	Super::OnConstruction(Transform);
+}
+
+void AEnemyBase::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	for (const FSoftObjectPath& Asset : { EnemyMeshAsset.ToSoftObjectPath(), EnemyMaterialAsset.ToSoftObjectPath() })
+	{
+		if (Asset.IsValid())
+		{
+			OutAssets.AddUnique(Asset);
+		}
+	}
+	if (!ShouldStripCosmetics())
+	{
+		for (const FSoftObjectPath& Asset : { ExplosionEmitterAsset.ToSoftObjectPath(), ExplosionSoundAsset.ToSoftObjectPath() })
+		{
+			if (Asset.IsValid())
+			{
+				OutAssets.AddUnique(Asset);
+			}
+		}
+	}
+}
+
 // Called when the game starts or when spawned
 void AEnemyBase::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (const AGeoGameState* CurrentGameState = GetWorld()->GetGameState<AGeoGameState>())
+	{
+		if (const FGeoQualitySettings* Quality = CurrentGameState->GetQualitySettings())
+		{
+			ApplyQualitySettings(*Quality);
+		}
+	}
+
+	if (bWarmUp)
+	{
+		WarmUp();
+		return;
+	}
+
+	/** warm-up copies are not live enemies  */
+	INC_DWORD_STAT(STAT_LiveEnemies);
+	FSillyGeoFrameEvents::LiveEnemies++;
+
+	/** net proxies too, so homing shots of clients find them  */
+	if (AGeoGameState* CurrentGameState = GetWorld()->GetGameState<AGeoGameState>())
+	{
+		IndexHandle = CurrentGameState->AddIndexedEnemy(this);
+	}
+
+	/** net proxies are moved by replicated state only  */
+	if (bNetProxy)
+	{
+		EnemyMovement->SetComponentTickEnabled(false);
+		return;
+	}
+
 	OnActorBeginOverlap.AddDynamic(this, &AEnemyBase::OnEnemyOverlapBegin);
 	
 	/** sets a target to follow  */
 	InitTarget();
 
 	/** starts enemies timers  */
-	StartTimers();
-
-	RandomVector = FMath::VRand();	
+	ChangeSteering();
 }
 
 void AEnemyBase::InitTarget()
@@ -103,8 +169,9 @@ void AEnemyBase::InitTarget()
 			if (ASillyGeoGameMode* SillyGeoGameMode = Cast<ASillyGeoGameMode>(World->GetAuthGameMode()))
 			{
 				PlayerPawn = SillyGeoGameMode->GetRandomPlayerPawn();
-				if (PlayerPawn == nullptr)
+				if (PlayerPawn == nullptr || PlayerPawn->IsPendingKill())
 				{
+					PlayerPawn = nullptr;
 					bRandomShift = true;
 					UE_LOG(LogTemp, Error, TEXT("PlayerPawn == nullptr"));
 				}
@@ -115,79 +182,155 @@ void AEnemyBase::InitTarget()
 
 void AEnemyBase::StartTimers()
 {
+	GetWorldTimerManager().ClearTimer(RandomShiftTimer);
 	if (bRandomShift)
 	{
-		FTimerDelegate RandomShiftDelegate;
-		RandomShiftDelegate.BindLambda([&]
-		{
-			RandomDirection = FMath::VRand() * FMath::RandRange(800.f, 8000.f);
-		}
-		);
-
-		FTimerHandle RandomShiftTimer;
-		GetWorldTimerManager().SetTimer(RandomShiftTimer, RandomShiftDelegate, FMath::RandRange(0.5f, 1.f), true);
+		GetWorldTimerManager().SetTimer(RandomShiftTimer, this, &AEnemyBase::RandomShift, SteeringStream.FRandRange(0.5f, 1.f), true);
 	}
 
 	/** start random change behavior  */
-	FTimerHandle TrackTimer;
 	GetWorldTimerManager().SetTimer(TrackTimer, this, &AEnemyBase::Tracking, TrackingDelay, true);
 }
 
+void AEnemyBase::RandomShift()
+{
+	/** separate statements, so the order of draws from the stream is the same on every machine */
+	const FVector ShiftDirection = SteeringStream.GetUnitVector();
+	RandomDirection = ShiftDirection * SteeringStream.FRandRange(800.f, 8000.f);
+}
+
 // Called every frame
 void AEnemyBase::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (bNetProxy)
+	{
+		if (bNetSimulated)
+		{
+			Follow();
+		}
+		else
+		{
+			FollowNetState(DeltaTime);
+		}
+		return;
+	}
+
+	/** our target is gone, chase somebody else  */
+	if (PlayerPawn && PlayerPawn->IsPendingKill())
+	{
+		/** InitTarget picks a player only if we have none, then the steering restarts for the new one */
+		PlayerPawn = nullptr;
+		InitTarget();
+		SetTarget(PlayerPawn);
+	}
+
 	/** calls to follow the player  */
 	Follow();
+
+	/** update replicated state  */
+	if (GeoGameState)
+	{
+		GeoGameState->UpdateEnemy(this);
+	}
+}
+
+void AEnemyBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	/** net proxies come and go with relevancy, nothing may fire on a destroyed one */
+	GetWorldTimerManager().ClearTimer(TrackTimer);
+	GetWorldTimerManager().ClearTimer(RandomShiftTimer);
+
+	if (!bWarmUp)
+	{
+		DEC_DWORD_STAT(STAT_LiveEnemies);
+		FSillyGeoFrameEvents::LiveEnemies--;
+	}
+
+	if (GeoGameState && !bNetProxy)
+	{
+		GeoGameState->UnregisterEnemy(this);
+	}
+
+	AGeoGameState* CurrentGameState = GetWorld() ? GetWorld()->GetGameState<AGeoGameState>() : nullptr;
+	if (CurrentGameState && IndexHandle != INDEX_NONE)
+	{
+		CurrentGameState->RemoveIndexedEnemy(IndexHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AEnemyBase::SetDefaultValues(bool bNewSpinning /*= false*/, bool bShifting /*= false*/, EEnemyColor Color /*= EEnemyColor::EN_Red*/, class UMaterialInterface* Mat /*= nullptr*/, class UStaticMesh* Mesh /*= nullptr*/, float Speed /*= 400.f*/)
 {
 	bSpinning = bNewSpinning;
 	bRandomShift = bShifting;
-	EnemyColor = Color;
 	CoreMaterial = Mat;
 	EnemyMesh->SetStaticMesh(Mesh);
 
-	switch (EnemyColor)
+	/** init speed  */
+	EnemyMovementSpeed = Speed;
+
+	/** create enemy dynamic material  */
+	if (EnemyMesh && !ShouldStripCosmetics())
+	{
+		SILLYGEO_LLM_SCOPE(DynamicMaterials);
+		EnemyDynamicMaterial = EnemyMesh->CreateDynamicMaterialInstance(0, CoreMaterial);
+	}
+
+	SetColorType(Color);
+}
+
+FLinearColor AEnemyBase::GetColorOfType(EEnemyColor Color)
+{
+	switch (Color)
 	{
 	case EEnemyColor::EN_Blue:
-		CurrentColor = FLinearColor::Blue;
-		break;
+		return FLinearColor::Blue;
 
 	case EEnemyColor::EN_Green:
-		CurrentColor = FLinearColor::Green;
-		break;
+		return FLinearColor::Green;
 
 	case EEnemyColor::EN_Red:
-		CurrentColor = FLinearColor::Red;
-		break;
+		return FLinearColor::Red;
 
 	case EEnemyColor::EN_Yellow:
-		CurrentColor = FLinearColor::Yellow;
-		break;
+		return FLinearColor::Yellow;
 
 	default:
-		break;
+		return FLinearColor::Black;
 	}
+}
 
-	/** init speed  */
-	EnemyMovementSpeed = Speed;
-
-	/** create enemy dynamic material  */
-	if (EnemyMesh)
+bool AEnemyBase::FindColorType(const FLinearColor& Color, EEnemyColor& OutColorType)
+{
+	for (EEnemyColor ColorType : { EEnemyColor::EN_Green, EEnemyColor::EN_Red, EEnemyColor::EN_Blue, EEnemyColor::EN_Yellow })
 	{
-		EnemyDynamicMaterial = EnemyMesh->CreateDynamicMaterialInstance(0, CoreMaterial);
-		if (EnemyDynamicMaterial)
+		if (GetColorOfType(ColorType) == Color)
 		{
-			EnemyDynamicMaterial->SetVectorParameterValue("EnemyColor", CurrentColor);
+			OutColorType = ColorType;
+			return true;
 		}
 	}
+	return false;
+}
+
+void AEnemyBase::SetColorType(EEnemyColor Color)
+{
+	EnemyColor = Color;
+	CurrentColor = GetColorOfType(EnemyColor);
+
+	if (EnemyDynamicMaterial)
+	{
+		EnemyDynamicMaterial->SetVectorParameterValue("EnemyColor", CurrentColor);
+	}
 }
 
 void AEnemyBase::Tracking()
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_EnemyTracking, EnemyTracking);
+
 	FVector PlayerLocaion = PlayerPawn ? PlayerPawn->GetActorLocation() * FVector(1.f, 1.f, 0.f) : FVector(0.f, 0.f, 0.f);
 	FVector MyLocation = GetActorLocation() + RandomDirection * FVector(1.f, 1.f, 0.f);
 	FRotator RotatorFromX = FRotationMatrix::MakeFromX(PlayerLocaion - MyLocation).Rotator();
@@ -196,6 +339,8 @@ void AEnemyBase::Tracking()
 
 void AEnemyBase::Follow()
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_EnemyFollow, EnemyFollow);
+
 	EnemyMovement->Velocity = Destination;
 }
 
@@ -219,6 +364,14 @@ void AEnemyBase::OnEnemyOverlapBegin(AActor* OverlappedActor, AActor* OtherActor
 
 float AEnemyBase::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_EnemyTakeDamage, EnemyTakeDamage);
+
+	/** net proxies are killed by the server only  */
+	if (bNetProxy)
+	{
+		return 0.f;
+	}
+
 	const float ActualDamage = Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
 	if (ActualDamage > 0.f)
 	{
@@ -228,35 +381,12 @@ float AEnemyBase::TakeDamage(float Damage, struct FDamageEvent const& DamageEven
 		{
 			if (Health <= 0.f) /** we are dead  */
 			{
-				SpawnExplodeFX();
-				
-				/** add 1 enemy killed to player state  */
-				if (EventInstigator)
+				/** the same bookkeeping as a blast batch of one enemy  */
+				if (GeoGameMode)
 				{
-					if(AGeo* Geo = Cast<AGeo>(EventInstigator->GetPawn()))
-					{
-						if (AGeoPlayerState* GeoPlayerState = Cast<AGeoPlayerState>(Geo->PlayerState))
-						{
-							GeoPlayerState->EnemiesKilled++;
-						}
-					}
+					GeoGameMode->OnEnemiesKilled({ this }, EventInstigator);
 				}
-
-				/** update game state  */
-				if (GeoGameState && GeoGameMode)
-				{
-					/** remove one enemy  */
-					GeoGameState->AddEnemiesRemaining(-1);
-
-					GeoGameMode->UpdateHUD();
-
-					/** if we haven't alive enemies on map and we haven't enemies to spawn */
-					if (GeoGameState->GetEnemiesRemaining() <= 0 && !GeoGameMode->HasEnemiesToSpawn())
-					{
-						GeoGameMode->EndWave();
-					}
-				}
-				Destroy();
+				Die(true);
 			}
 		}
 	}
@@ -264,11 +394,39 @@ float AEnemyBase::TakeDamage(float Damage, struct FDamageEvent const& DamageEven
 	return ActualDamage;
 }
 
+bool AEnemyBase::ApplyBatchDamage(float Damage)
+{
+	if (bNetProxy || Health <= 0.f || IsPendingKill())
+	{
+		return false;
+	}
+
+	Health -= Damage;
+	return Health <= 0.f;
+}
+
+void AEnemyBase::Die(bool bExplode)
+{
+	SILLYGEO_FRAME_EVENT(EnemyKilled);
+	if (bExplode)
+	{
+		SpawnExplodeFX();
+	}
+	Destroy();
+}
+
 void AEnemyBase::SpawnExplodeFX()
 {
-	/** spawn explosion FX  */
-	if (ExplosionEmitter)
+	if (ShouldStripCosmetics())
 	{
+		return;
+	}
+
+	/** spawn explosion FX, if the quality tier has the budget for it */
+	AGeoGameState* CurrentGameState = GetWorld()->GetGameState<AGeoGameState>();
+	if (ExplosionEmitter && !bLowSignificance && (!CurrentGameState || CurrentGameState->ConsumeExplosionFX(GetActorLocation())))
+	{
+		SILLYGEO_LLM_SCOPE(FX);
 		UParticleSystemComponent* ExplodeFX = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEmitter, GetActorTransform());
 		if (ExplodeFX)
 		{
@@ -284,6 +442,28 @@ void AEnemyBase::SpawnExplodeFX()
 	}
 }
 
+void AEnemyBase::ApplyQualitySettings(const FGeoQualitySettings& Settings)
+{
+	bQualityPulse = Settings.bEnemyPulse;
+	UpdatePulse();
+}
+
+void AEnemyBase::SetViewSignificance(bool bSignificant)
+{
+	if (bLowSignificance == !bSignificant) { return; }
+
+	bLowSignificance = !bSignificant;
+	UpdatePulse();
+}
+
+void AEnemyBase::UpdatePulse()
+{
+	if (EnemyDynamicMaterial)
+	{
+		EnemyDynamicMaterial->SetScalarParameterValue("PulseScale", bQualityPulse && !bLowSignificance ? 1.f : 0.f);
+	}
+}
+
 void AEnemyBase::InitReferences(class ASillyGeoGameMode* NewGM, class AGeoGameState* NewGS)
 {
 	if (!ensure(NewGM)) { return; }
@@ -291,9 +471,181 @@ void AEnemyBase::InitReferences(class ASillyGeoGameMode* NewGM, class AGeoGameSt
 
 	GeoGameState = NewGS;
 	GeoGameMode = NewGM;
+
+	/** start replicating our state  */
+	GeoGameState->RegisterEnemy(this);
+}
+
+void AEnemyBase::RestoreState(float NewHealth, EEnemyColor NewColor, const FVector& NewVelocity)
+{
+	Health = NewHealth;
+	SetColorType(NewColor);
+
+	/** keep flying this way until the next Tracking() */
+	Destination = NewVelocity;
+	EnemyMovement->Velocity = NewVelocity;
 }
 
 void AEnemyBase::SetTarget(class APawn* TargetPawn)
 {
 	PlayerPawn = TargetPawn;
+
+	/** the target changed, so everybody has to restart the steering  */
+	if (HasActorBegunPlay() && !bNetProxy)
+	{
+		ChangeSteering();
+	}
+}
+
+void AEnemyBase::RestartSteering(uint16 NewSeed)
+{
+	SteeringSeed = NewSeed;
+	SteeringStream.Initialize(SteeringSeed);
+
+	RandomVector = SteeringStream.GetUnitVector();
+	RandomDirection = FVector::ZeroVector;
+
+	StartTimers();
+}
+
+void AEnemyBase::ChangeSteering()
+{
+	/** any seed but the current one, so clients can tell the steering restarted  */
+	RestartSteering((uint16)(SteeringSeed + 1 + FMath::RandHelper(MAX_uint16 - 1)));
+
+	if (GeoGameState)
+	{
+		GeoGameState->UpdateEnemySteering(this);
+	}
+}
+
+float AEnemyBase::GetHitRadius() const
+{
+	return HitSphere->GetScaledSphereRadius();
+}
+
+void AEnemyBase::InitWarmUp(float LifeSpan)
+{
+	bWarmUp = true;
+	InitialLifeSpan = LifeSpan;
+}
+
+void AEnemyBase::WarmUp()
+{
+	SetActorTickEnabled(false);
+	SetActorEnableCollision(false);
+	EnemyMovement->SetComponentTickEnabled(false);
+
+	if (ShouldStripCosmetics())
+	{
+		return;
+	}
+
+	/** the first emitter of the template initializes it  */
+	if (ExplosionEmitter)
+	{
+		SILLYGEO_LLM_SCOPE(FX);
+		if (UParticleSystemComponent* ExplodeFX = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEmitter, GetActorTransform()))
+		{
+			ExplodeFX->SetColorParameter("EnemyColor", CurrentColor);
+		}
+	}
+
+	/** decompress the sound now, not on the first kill  */
+	FAudioDevice* AudioDevice = GetWorld()->GetAudioDevice();
+	if (AudioDevice && ExplosionSound)
+	{
+		TArray<USoundNodeWavePlayer*> WavePlayers;
+		USoundCue* SoundCue = Cast<USoundCue>(ExplosionSound);
+		if (SoundCue && SoundCue->FirstNode)
+		{
+			SoundCue->RecursiveFindNode<USoundNodeWavePlayer>(SoundCue->FirstNode, WavePlayers);
+		}
+		for (USoundNodeWavePlayer* WavePlayer : WavePlayers)
+		{
+			if (USoundWave* SoundWave = WavePlayer->GetSoundWave())
+			{
+				AudioDevice->Precache(SoundWave);
+			}
+		}
+		if (USoundWave* SoundWave = Cast<USoundWave>(ExplosionSound))
+		{
+			AudioDevice->Precache(SoundWave);
+		}
+	}
+}
+
+void AEnemyBase::InitNetProxy(int32 NewNetId)
+{
+	NetId = NewNetId;
+	bNetProxy = true;
+	NetLocation = GetActorLocation();
+	NetVelocity = FVector::ZeroVector;
+	NetReceiveTime = GetWorld()->GetTimeSeconds();
+}
+
+void AEnemyBase::ApplyNetState(const FVector& NewLocation, const FVector& NewVelocity, float NewYaw, EEnemyColor NewColor)
+{
+	NetLocation = NewLocation;
+	NetVelocity = NewVelocity;
+	NetReceiveTime = GetWorld()->GetTimeSeconds();
+
+	SetActorRotation(FRotator(0.f, NewYaw, 0.f));
+
+	if (NewColor != EnemyColor)
+	{
+		SetColorType(NewColor);
+	}
+}
+
+void AEnemyBase::ApplyNetSteering(bool bDormant, uint16 Seed, class APawn* Target)
+{
+	if (!bDormant)
+	{
+		/** back to extrapolation of replicated state  */
+		if (bNetSimulated)
+		{
+			bNetSimulated = false;
+			GetWorldTimerManager().ClearTimer(TrackTimer);
+			GetWorldTimerManager().ClearTimer(RandomShiftTimer);
+			EnemyMovement->SetComponentTickEnabled(false);
+		}
+		return;
+	}
+
+	/** start from the replicated state  */
+	SetActorLocation(NetLocation);
+	if (bNetSimulated && Seed == SteeringSeed)
+	{
+		/** only a location correction, keep steering  */
+		return;
+	}
+
+	bNetSimulated = true;
+	PlayerPawn = Target;
+	if (!PlayerPawn)
+	{
+		bRandomShift = true;
+	}
+
+	Destination = NetVelocity;
+	EnemyMovement->Velocity = NetVelocity;
+	EnemyMovement->SetComponentTickEnabled(true);
+	RestartSteering(Seed);
+}
+
+void AEnemyBase::FollowNetState(float DeltaTime)
+{
+	/** extrapolate replicated state and smoothly move towards it  */
+	const FVector Target = NetLocation + NetVelocity * (GetWorld()->GetTimeSeconds() - NetReceiveTime);
+	SetActorLocation(FMath::VInterpTo(GetActorLocation(), Target, DeltaTime, NetInterpSpeed));
+}
+
+void AEnemyBase::DestroyNetProxy(bool bExplode)
+{
+	if (bExplode)
+	{
+		SpawnExplodeFX();
+	}
+	Destroy();
 }
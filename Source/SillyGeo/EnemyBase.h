@@ -47,29 +47,87 @@ class SILLYGEO_API AEnemyBase : public AActor
 	/** explosion sound */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	class USoundBase* ExplosionSound;
+
+	/** enemy mesh, material and explosion FX, so the class loads without them  */
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UStaticMesh> EnemyMeshAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UMaterialInterface> EnemyMaterialAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UParticleSystem> ExplosionEmitterAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class USoundBase> ExplosionSoundAsset;
 	
 public:
 	
 	/** Apply damage to this actor. */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
+
+	/** [server] subtracts blast damage without TakeDamage and kill bookkeeping,
+	*	returns true if this damage killed the enemy. The blast resolver reports the kill
+	*/
+	bool ApplyBatchDamage(float Damage);
+
+	/** destroys the killed enemy, the explosion is skipped for all but one enemy of a blast batch */
+	void Die(bool bExplode);
 	
 	/** calls when this actor spawned to set Game mode and Game state references  */
 	void InitReferences(class ASillyGeoGameMode* NewGM, class AGeoGameState* NewGS);
 
-	/** calls to set the target pawn for this enemy  */
+	/** calls to set the target pawn for this enemy, nullptr clears the target  */
 	void SetTarget(class APawn* TargetPawn);
 
+	/** [client] calls before FinishSpawning to make this enemy a local representation of replicated one */
+	void InitNetProxy(int32 NewNetId);
+
+	/** [client] calls when new replicated state is received  */
+	void ApplyNetState(const FVector& NewLocation, const FVector& NewVelocity, float NewYaw, EEnemyColor NewColor);
+
+	/** [client] calls after ApplyNetState, dormant proxies steer themselves from the replicated seed and target */
+	void ApplyNetSteering(bool bDormant, uint16 Seed, class APawn* Target);
+
+	/** [client] calls when replicated enemy is gone  */
+	void DestroyNetProxy(bool bExplode);
+
+	/** [server] calls right after spawning (before InitReferences) to put the enemy back into the state of an arena snapshot */
+	void RestoreState(float NewHealth, EEnemyColor NewColor, const FVector& NewVelocity);
+
+	/** adds default assets of this enemy to preload  */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** turns material pulse on / off according to the quality tier  */
+	void ApplyQualitySettings(const struct FGeoQualitySettings& Settings);
+
+	/** [split-screen] calls with the result of the significance pass shared by all local views,
+	*	enemies far from every view don't pulse and don't spawn explosion emitters
+	*/
+	void SetViewSignificance(bool bSignificant);
+
+	/** [server] calls before FinishSpawning to make this enemy a warm-up copy: it doesn't move, collide
+	*	or count, it only renders its materials and plays its explosion FX once as a speck in front of the camera, then dies
+	*/
+	void InitWarmUp(float LifeSpan);
+
 protected:
 
 	// Sets default values for this actor's properties
 	AEnemyBase();
 
+	/** fills empty components and properties with default assets  */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	/** unregisters replicated enemy  */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 
 	/** sets a target to follow  */
@@ -88,6 +146,9 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void SpawnExplodeFX();
 
+	/** calls on BeginPlay of warm-up copy to initialize explosion emitter and sound */
+	void WarmUp();
+
 	/** calls by designer in construction script */
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void SetDefaultValues(bool bNewSpinning = false, bool bShifting = false, EEnemyColor Color = EEnemyColor::EN_Red, class UMaterialInterface* Mat = nullptr, class UStaticMesh* Mesh = nullptr, float Speed = 400.f);
@@ -100,6 +161,24 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void Tracking();
 
+	/** [timer] picks a new random shift of the destination from the steering stream */
+	void RandomShift();
+
+	/** calls to set the color of this enemy  */
+	UFUNCTION(BlueprintCallable, Category = "AAA")
+	void SetColorType(EEnemyColor Color);
+
+	/** [tick] calls to move net proxy towards extrapolated replicated state  */
+	void FollowNetState(float DeltaTime);
+
+	/** reseeds steering random stream and restarts steering timers, so every machine
+	*	given the same seed and target steers the same way from now on
+	*/
+	void RestartSteering(uint16 NewSeed);
+
+	/** [server] restarts steering with a new seed and tells the clients about it  */
+	void ChangeSteering();
+
 	// -----------------------------------------------------------------------------------
 
 	/** the color of enemy. this parameter specify enemy body color
@@ -129,10 +208,21 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	float SpinRate = 2.f;
 
-	/** TODO  */
+	/** random unit vector drawn from steering stream when steering starts  */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	FVector RandomVector;
 
+	/** the seed of steering stream  */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	int32 SteeringSeed = 0;
+
+	/** all steering randomness is drawn from here  */
+	FRandomStream SteeringStream;
+
+	/** steering timers  */
+	FTimerHandle TrackTimer;
+	FTimerHandle RandomShiftTimer;
+
 	/** the direction of random movement ( bRandomShift == true )  */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	FVector RandomDirection;
@@ -164,10 +254,80 @@ private:
 	/** players pawn that we actually hunting  */
 	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	class APawn* PlayerPawn;
+
+	/** how fast net proxy catches up with replicated state  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float NetInterpSpeed = 10.f;
+
+	/** id of this enemy in replicated enemies array  */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	int32 NetId = INDEX_NONE;
+
+	/** shows whether this enemy is a client side representation of replicated enemy */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	uint32 bNetProxy : 1;
+
+	/** shows whether this net proxy is dormant and steers itself  */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	uint32 bNetSimulated : 1;
+
+	/** shows whether this enemy is a hidden warm-up copy spawned during the rest before its wave */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	uint32 bWarmUp : 1;
+
+	/** the quality tier allows material pulse  */
+	uint32 bQualityPulse : 1;
+
+	/** [split-screen] this enemy is far from every local view  */
+	uint32 bLowSignificance : 1;
+
+	/** sets PulseScale of the enemy material from quality and significance */
+	void UpdatePulse();
+
+	/** handle of this enemy in the enemy spatial index of the game state  */
+	int32 IndexHandle = INDEX_NONE;
+
+	/** [client] last replicated location / velocity and the time we received it  */
+	FVector NetLocation;
+	FVector NetVelocity;
+	float NetReceiveTime;
 	
 public:
 	
 	/** returns enemy color **/
 	FORCEINLINE FLinearColor GetEnemyColor() const { return CurrentColor; }
+
+	/** returns the radius of enemy hit sphere **/
+	float GetHitRadius() const;
+
+	/** returns enemy color type **/
+	FORCEINLINE EEnemyColor GetColorType() const { return EnemyColor; }
+
+	/** returns the color of enemies of specified type **/
+	static FLinearColor GetColorOfType(EEnemyColor Color);
+
+	/** finds the enemy type of specified color, returns false if no enemy has it **/
+	static bool FindColorType(const FLinearColor& Color, EEnemyColor& OutColorType);
+
+	/** returns the id of this enemy in replicated enemies array **/
+	FORCEINLINE int32 GetNetId() const { return NetId; }
+
+	/** sets the id of this enemy in replicated enemies array **/
+	FORCEINLINE void SetNetId(int32 NewNetId) { NetId = NewNetId; }
+
+	/** returns true if this enemy is a client side representation of replicated enemy **/
+	FORCEINLINE bool IsNetProxy() const { return bNetProxy; }
+
+	/** returns true if this enemy only warms up its class before the wave **/
+	FORCEINLINE bool IsWarmUp() const { return bWarmUp; }
+
+	/** returns the seed of steering random stream **/
+	FORCEINLINE uint16 GetSteeringSeed() const { return (uint16)SteeringSeed; }
+
+	/** returns current health **/
+	FORCEINLINE float GetHealth() const { return Health; }
+
+	/** returns the pawn we are chasing **/
+	FORCEINLINE class APawn* GetTarget() const { return PlayerPawn; }
 	
 };
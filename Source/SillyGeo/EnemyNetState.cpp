@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EnemyNetState.h"
+#include "GeoGameState.h"
+#include "Engine/World.h"
+
+uint32 FEnemyNetEntry::BytesWritten = 0;
+
+bool FEnemyNetEntry::UpdateState(const FVector& NewLocation, const FVector& NewVelocity, float NewYaw, float Time)
+{
+	const int16 NewVelocityX = (int16)FMath::Clamp(FMath::RoundToInt(NewVelocity.X), -MAX_int16, (int32)MAX_int16);
+	const int16 NewVelocityY = (int16)FMath::Clamp(FMath::RoundToInt(NewVelocity.Y), -MAX_int16, (int32)MAX_int16);
+
+	/** where the clients think we are right now  */
+	const FVector Extrapolated = GetLocation() + GetVelocity() * (Time - LastUpdateTime);
+	const bool bVelocityChanged = NewVelocityX != VelocityX || NewVelocityY != VelocityY;
+	const bool bDrifted = (Extrapolated - NewLocation).SizeSquared2D() > FMath::Square(MaxExtrapolationError);
+
+	if (!bVelocityChanged && !bDrifted)
+	{
+		return false;
+	}
+
+	SetState(NewLocation, NewVelocity, NewYaw, Time);
+	return true;
+}
+
+void FEnemyNetEntry::SetState(const FVector& NewLocation, const FVector& NewVelocity, float NewYaw, float Time)
+{
+	LocationX = (int16)FMath::Clamp(FMath::RoundToInt(NewLocation.X / LocationScale), -MAX_int16, (int32)MAX_int16);
+	LocationY = (int16)FMath::Clamp(FMath::RoundToInt(NewLocation.Y / LocationScale), -MAX_int16, (int32)MAX_int16);
+	VelocityX = (int16)FMath::Clamp(FMath::RoundToInt(NewVelocity.X), -MAX_int16, (int32)MAX_int16);
+	VelocityY = (int16)FMath::Clamp(FMath::RoundToInt(NewVelocity.Y), -MAX_int16, (int32)MAX_int16);
+	Heading = (uint8)(FMath::RoundToInt(FRotator::ClampAxis(NewYaw) * (256.f / 360.f)) & 0xFF);
+	LastUpdateTime = Time;
+}
+
+void FEnemyNetEntry::CopyState(const FEnemyNetEntry& Source)
+{
+	EnemyId = Source.EnemyId;
+	ArchetypeIndex = Source.ArchetypeIndex;
+	Color = Source.Color;
+	LocationX = Source.LocationX;
+	LocationY = Source.LocationY;
+	VelocityX = Source.VelocityX;
+	VelocityY = Source.VelocityY;
+	Heading = Source.Heading;
+	TargetId = Source.TargetId;
+	SteeringSeed = Source.SteeringSeed;
+	bDormant = Source.bDormant;
+	SourceKey = Source.ReplicationKey;
+}
+
+bool FEnemyNetEntry::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 PackedId = (uint32)EnemyId;
+	Ar.SerializeIntPacked(PackedId);
+
+	/** 6 bits archetype, 2 bits color  */
+	uint8 ArchetypeAndColor = (ArchetypeIndex & (MaxArchetypes - 1)) | ((uint8)Color << 6);
+	Ar << ArchetypeAndColor;
+
+	Ar << LocationX;
+	Ar << LocationY;
+	Ar << VelocityX;
+	Ar << VelocityY;
+	Ar << Heading;
+
+	/** target id + 1 with dormant flag in the lowest bit, the seed only for dormant entries  */
+	uint32 PackedTarget = ((uint32)(TargetId + 1) << 1) | (bDormant ? 1 : 0);
+	Ar.SerializeIntPacked(PackedTarget);
+	if (PackedTarget & 1)
+	{
+		Ar << SteeringSeed;
+	}
+
+	if (Ar.IsLoading())
+	{
+		EnemyId = (int32)PackedId;
+		ArchetypeIndex = ArchetypeAndColor & (MaxArchetypes - 1);
+		Color = (EEnemyColor)(ArchetypeAndColor >> 6);
+		TargetId = (int32)(PackedTarget >> 1) - 1;
+		bDormant = (PackedTarget & 1) != 0;
+	}
+	else
+	{
+		BytesWritten += GetPackedBytes(PackedId) + GetPackedBytes(PackedTarget) + (bDormant ? 12 : 10);
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+uint32 FEnemyNetEntry::GetPackedBytes(uint32 Value)
+{
+	uint32 Bytes = 1;
+	for (Value >>= 7; Value > 0; Value >>= 7)
+	{
+		Bytes++;
+	}
+	return Bytes;
+}
+
+uint32 FEnemyNetEntry::ConsumeBytesWritten()
+{
+	const uint32 Result = BytesWritten;
+	BytesWritten = 0;
+	return Result;
+}
+
+/** returns the game state handling replicated enemies in the world of the array owner  */
+static AGeoGameState* GetEnemyNetHandler(const FEnemyNetArray& InArraySerializer)
+{
+	UWorld* World = InArraySerializer.Owner ? InArraySerializer.Owner->GetWorld() : nullptr;
+	return World ? World->GetGameState<AGeoGameState>() : nullptr;
+}
+
+void FEnemyNetEntry::PreReplicatedRemove(const FEnemyNetArray& InArraySerializer)
+{
+	if (AGeoGameState* GeoGameState = GetEnemyNetHandler(InArraySerializer))
+	{
+		GeoGameState->OnEnemyNetRemoved(*this);
+	}
+}
+
+void FEnemyNetEntry::PostReplicatedAdd(const FEnemyNetArray& InArraySerializer)
+{
+	if (AGeoGameState* GeoGameState = GetEnemyNetHandler(InArraySerializer))
+	{
+		GeoGameState->OnEnemyNetAdded(*this);
+	}
+}
+
+void FEnemyNetEntry::PostReplicatedChange(const FEnemyNetArray& InArraySerializer)
+{
+	if (AGeoGameState* GeoGameState = GetEnemyNetHandler(InArraySerializer))
+	{
+		GeoGameState->OnEnemyNetChanged(*this);
+	}
+}
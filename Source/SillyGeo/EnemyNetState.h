@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "EnemyBase.h"
+#include "EnemyNetState.generated.h"
+
+/**
+*	replicated 2D state of one enemy.
+*	Everything sits on the Z=0 plane so we only send quantized X/Y location,
+*	X/Y velocity and heading. The server updates an entry only when client
+*	extrapolation (Location + Velocity * time) would drift too far.
+*	Dormant entries aren't extrapolated: clients simulate the enemy steering
+*	from the seed and the target, the server sends them again only when the steering
+*	restarts (new target) or as a rare location correction
+*/
+USTRUCT()
+struct FEnemyNetEntry : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** uu per quantized location unit, int16 gives us +-65k uu  */
+	static constexpr float LocationScale = 2.f;
+
+	/** archetype index has 6 bits in NetSerialize  */
+	static constexpr int32 MaxArchetypes = 64;
+
+	/** max distance (in uu) between real and extrapolated location before the entry is dirtied */
+	static constexpr float MaxExtrapolationError = 8.f;
+
+	/** server unique id of the enemy  */
+	UPROPERTY()
+	int32 EnemyId = INDEX_NONE;
+
+	/** index into AGeoGameState enemy archetypes  */
+	UPROPERTY()
+	uint8 ArchetypeIndex = 0;
+
+	/** the color of the enemy  */
+	UPROPERTY()
+	EEnemyColor Color = EEnemyColor::EN_Red;
+
+	/** quantized location  */
+	UPROPERTY()
+	int16 LocationX = 0;
+
+	UPROPERTY()
+	int16 LocationY = 0;
+
+	/** quantized velocity ( uu/s )  */
+	UPROPERTY()
+	int16 VelocityX = 0;
+
+	UPROPERTY()
+	int16 VelocityY = 0;
+
+	/** quantized yaw  */
+	UPROPERTY()
+	uint8 Heading = 0;
+
+	/** PlayerId of the player state whose pawn the enemy is chasing  */
+	UPROPERTY()
+	int32 TargetId = INDEX_NONE;
+
+	/** seed of the enemy steering random stream, changes every time the steering restarts  */
+	UPROPERTY()
+	uint16 SteeringSeed = 0;
+
+	/** shows whether clients simulate this enemy themselves  */
+	UPROPERTY()
+	bool bDormant = false;
+
+	/** [server] time of the last state update  */
+	float LastUpdateTime = 0.f;
+
+	/** [server] the enemy this entry belongs to  */
+	TWeakObjectPtr<AEnemyBase> Enemy;
+
+	/** [server] ReplicationKey of the master entry this copy was made from  */
+	int32 SourceKey = INDEX_NONE;
+
+	/** [server] updates the state, returns true if the entry has to be sent again */
+	bool UpdateState(const FVector& NewLocation, const FVector& NewVelocity, float NewYaw, float Time);
+
+	/** [server] writes the state no matter how far it is from extrapolated one  */
+	void SetState(const FVector& NewLocation, const FVector& NewVelocity, float NewYaw, float Time);
+
+	/** [server] copies replicated state of the master entry into per connection copy  */
+	void CopyState(const FEnemyNetEntry& Source);
+
+	/** returns dequantized location  */
+	FVector GetLocation() const { return FVector(LocationX * LocationScale, LocationY * LocationScale, 0.f); }
+
+	/** returns dequantized velocity  */
+	FVector GetVelocity() const { return FVector(VelocityX, VelocityY, 0.f); }
+
+	/** returns dequantized yaw  */
+	float GetYaw() const { return Heading * (360.f / 256.f); }
+
+	/** compact bit packing of the entry  */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** fast array callbacks, forwarded to the game state on clients  */
+	void PreReplicatedRemove(const struct FEnemyNetArray& InArraySerializer);
+	void PostReplicatedAdd(const struct FEnemyNetArray& InArraySerializer);
+	void PostReplicatedChange(const struct FEnemyNetArray& InArraySerializer);
+
+	/** bytes written by NetSerialize since the last call to ConsumeBytesWritten  */
+	static uint32 ConsumeBytesWritten();
+
+private:
+
+	/** returns how many bytes SerializeIntPacked writes for the value  */
+	static uint32 GetPackedBytes(uint32 Value);
+
+	static uint32 BytesWritten;
+};
+
+template<>
+struct TStructOpsTypeTraits<FEnemyNetEntry> : public TStructOpsTypeTraitsBase2<FEnemyNetEntry>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/** fast array of all replicated enemies, only dirty entries are sent  */
+USTRUCT()
+struct FEnemyNetArray : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FEnemyNetEntry> Items;
+
+	/** the actor owning this array  */
+	class AActor* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FEnemyNetEntry, FEnemyNetArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FEnemyNetArray> : public TStructOpsTypeTraitsBase2<FEnemyNetArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EnemyPositionHistory.h"
+
+void FEnemyPositionHistory::Init(float WindowSeconds, float SampleRate)
+{
+	if (!ensure(WindowSeconds > 0.f && SampleRate > 0.f)) { return; }
+
+	NumSamples = FMath::CeilToInt(WindowSeconds * SampleRate) + 1;
+	SampleInterval = 1.f / SampleRate;
+	NextSampleTime = 0.f;
+	HeadSample = INDEX_NONE;
+	RecordedSamples = 0;
+
+	SampleTimes.Init(0.f, NumSamples);
+	LocationsX.Empty();
+	LocationsY.Empty();
+	SlotStartTimes.Empty();
+	EnemySlots.Empty();
+	FreeSlots.Empty();
+}
+
+void FEnemyPositionHistory::BeginSample(float Time)
+{
+	HeadSample = (HeadSample + 1) % NumSamples;
+	SampleTimes[HeadSample] = Time;
+	RecordedSamples = FMath::Min(RecordedSamples + 1, NumSamples);
+	NextSampleTime = Time + SampleInterval;
+}
+
+void FEnemyPositionHistory::Record(int32 EnemyId, const FVector& Location)
+{
+	const int32* Slot = EnemySlots.Find(EnemyId);
+	if (!Slot || HeadSample == INDEX_NONE) { return; }
+
+	const int32 Index = *Slot * NumSamples + HeadSample;
+	LocationsX[Index] = (int16)FMath::Clamp(FMath::RoundToInt(Location.X / LocationScale), -MAX_int16, (int32)MAX_int16);
+	LocationsY[Index] = (int16)FMath::Clamp(FMath::RoundToInt(Location.Y / LocationScale), -MAX_int16, (int32)MAX_int16);
+
+	/** the first sample of this enemy, older samples of the block belong to the previous owner */
+	if (SlotStartTimes[*Slot] == MAX_flt)
+	{
+		SlotStartTimes[*Slot] = SampleTimes[HeadSample];
+	}
+}
+
+void FEnemyPositionHistory::AddEnemy(int32 EnemyId)
+{
+	if (NumSamples == 0 || EnemySlots.Contains(EnemyId)) { return; }
+
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		Slot = SlotStartTimes.AddUninitialized();
+		LocationsX.AddZeroed(NumSamples);
+		LocationsY.AddZeroed(NumSamples);
+	}
+
+	/** not recorded yet  */
+	SlotStartTimes[Slot] = MAX_flt;
+	EnemySlots.Add(EnemyId, Slot);
+}
+
+void FEnemyPositionHistory::RemoveEnemy(int32 EnemyId)
+{
+	int32 Slot = INDEX_NONE;
+	if (EnemySlots.RemoveAndCopyValue(EnemyId, Slot))
+	{
+		FreeSlots.Add(Slot);
+	}
+}
+
+FVector2D FEnemyPositionHistory::GetSampleLocation(int32 Slot, int32 Sample) const
+{
+	const int32 Index = Slot * NumSamples + Sample;
+	return FVector2D(LocationsX[Index] * LocationScale, LocationsY[Index] * LocationScale);
+}
+
+bool FEnemyPositionHistory::GetLocationAtTime(int32 EnemyId, float Time, FVector2D& OutLocation) const
+{
+	const int32* Slot = EnemySlots.Find(EnemyId);
+	if (!Slot || RecordedSamples == 0 || SlotStartTimes[*Slot] == MAX_flt) { return false; }
+
+	auto RingIndex = [this](int32 SamplesBack) { return (HeadSample - SamplesBack + NumSamples) % NumSamples; };
+
+	/** clamp to the recorded window of this enemy  */
+	const float NewestTime = SampleTimes[HeadSample];
+	const float OldestTime = FMath::Max(SampleTimes[RingIndex(RecordedSamples - 1)], SlotStartTimes[*Slot]);
+	Time = FMath::Clamp(Time, OldestTime, NewestTime);
+
+	/** samples are ~SampleInterval apart, so guess the sample and fix the guess up */
+	int32 Back = FMath::Clamp(FMath::FloorToInt((NewestTime - Time) / SampleInterval), 0, RecordedSamples - 1);
+	while (Back < RecordedSamples - 1 && SampleTimes[RingIndex(Back)] > Time)
+	{
+		Back++;
+	}
+	while (Back > 0 && SampleTimes[RingIndex(Back - 1)] <= Time)
+	{
+		Back--;
+	}
+
+	const int32 Older = RingIndex(Back);
+	const int32 Newer = Back > 0 ? RingIndex(Back - 1) : Older;
+	const float Span = SampleTimes[Newer] - SampleTimes[Older];
+	const float Alpha = Span > 0.f ? FMath::Clamp((Time - SampleTimes[Older]) / Span, 0.f, 1.f) : 0.f;
+
+	OutLocation = FMath::Lerp(GetSampleLocation(*Slot, Older), GetSampleLocation(*Slot, Newer), Alpha);
+	return true;
+}
+
+bool FEnemyPositionHistory::ValidateHit(int32 EnemyId, float Time, const FVector2D& HitLocation, float Radius) const
+{
+	FVector2D EnemyLocation;
+	if (!GetLocationAtTime(EnemyId, Time, EnemyLocation))
+	{
+		return false;
+	}
+	return FVector2D::DistSquared(EnemyLocation, HitLocation) <= FMath::Square(Radius);
+}
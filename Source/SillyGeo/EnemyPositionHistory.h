@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+*	[server] recent 2D positions of all replicated enemies, used to rewind an enemy
+*	to the time a client saw it and validate the client hit.
+*	Positions are quantized to int16 and stored as structure of arrays,
+*	every enemy owns a fixed block of NumSamples X and Y values so the
+*	memory cost per enemy is fixed: NumSamples * 4 bytes
+*/
+class SILLYGEO_API FEnemyPositionHistory
+{
+public:
+
+	/** uu per quantized location unit  */
+	static constexpr float LocationScale = 2.f;
+
+	/** calls to (re)allocate history covering WindowSeconds recorded SampleRate times a second */
+	void Init(float WindowSeconds, float SampleRate);
+
+	/** returns true if we have to record a new sample at specified time  */
+	bool ShouldSample(float Time) const { return NumSamples > 0 && Time >= NextSampleTime; }
+
+	/** starts a new sample, calls Record for every enemy afterwards  */
+	void BeginSample(float Time);
+
+	/** records enemy location for the current sample  */
+	void Record(int32 EnemyId, const FVector& Location);
+
+	/** starts to track the enemy  */
+	void AddEnemy(int32 EnemyId);
+
+	/** stops to track the enemy, its block is reused by the next added one  */
+	void RemoveEnemy(int32 EnemyId);
+
+	/** returns the enemy location at specified time, false if we know nothing about this enemy */
+	bool GetLocationAtTime(int32 EnemyId, float Time, FVector2D& OutLocation) const;
+
+	/** cheap circle test of the rewound enemy against the hit location  */
+	bool ValidateHit(int32 EnemyId, float Time, const FVector2D& HitLocation, float Radius) const;
+
+	/** returns fixed memory cost of one enemy in bytes  */
+	int32 GetBytesPerEnemy() const { return NumSamples * 2 * sizeof(int16); }
+
+private:
+
+	/** returns the location of the enemy block at specified sample  */
+	FVector2D GetSampleLocation(int32 Slot, int32 Sample) const;
+
+	/** samples per enemy  */
+	int32 NumSamples = 0;
+
+	/** seconds between samples  */
+	float SampleInterval = 0.f;
+
+	/** the time we record the next sample at  */
+	float NextSampleTime = 0.f;
+
+	/** ring index of the latest sample  */
+	int32 HeadSample = INDEX_NONE;
+
+	/** how many samples of the ring are recorded already  */
+	int32 RecordedSamples = 0;
+
+	/** ring of sample times  */
+	TArray<float> SampleTimes;
+
+	/** quantized locations, [Slot * NumSamples + Sample]  */
+	TArray<int16> LocationsX;
+	TArray<int16> LocationsY;
+
+	/** the time each slot started to be recorded  */
+	TArray<float> SlotStartTimes;
+
+	/** enemy id -> slot  */
+	TMap<int32, int32> EnemySlots;
+
+	/** slots released by removed enemies  */
+	TArray<int32> FreeSlots;
+};
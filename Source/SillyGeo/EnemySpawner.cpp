@@ -5,6 +5,7 @@
 #include "EnemyBase.h"
 #include "SillyGeoGameMode.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "SillyGeoStats.h"
 
 // Sets default values
 AEnemySpawner::AEnemySpawner()
@@ -29,6 +30,9 @@ void AEnemySpawner::BeginPlay()
 
 AEnemyBase* AEnemySpawner::SpawnEnemy(TSubclassOf<class AEnemyBase> EnemyType)
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_SpawnerSpawnEnemy, SpawnerSpawnEnemy);
+	SILLYGEO_LLM_SCOPE(Enemies);
+
 	if (EnemyType)
 	{
 		UWorld* const World = GetWorld();
@@ -45,6 +49,7 @@ AEnemyBase* AEnemySpawner::SpawnEnemy(TSubclassOf<class AEnemyBase> EnemyType)
 			AEnemyBase* SpawnedEnemy = World->SpawnActor<AEnemyBase>(EnemyType, SpawnLocation, SpawnRotation, SpawnParams);
 			if (SpawnedEnemy)
 			{
+				SILLYGEO_FRAME_EVENT(EnemySpawned);
 				return SpawnedEnemy;
 			}
 		}
@@ -4,29 +4,37 @@
 #include "GeoGameState.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Camera/CameraComponent.h"
-#include "ConstructorHelpers.h"
-#include "GameFramework/CharacterMovementComponent.h"
-#include "Components/CapsuleComponent.h"
+#include "GeoMovementComponent.h"
+#include "Components/SphereComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Projectile.h"
+#include "Engine/StaticMesh.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "GeoPlayerController.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+#include "EnemyBase.h"
+#include "SillyGeo.h"
+#include "SillyGeoGameMode.h"
+#include "SillyGeoStats.h"
 
 // Sets default values
 AGeo::AGeo()
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+ 	// Set this pawn to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
-	/** root capsule  */
-	GetCapsuleComponent()->SetCapsuleHalfHeight(18.f);
-	GetCapsuleComponent()->SetCapsuleRadius(18.f);
-	GetCapsuleComponent()->SetEnableGravity(false);
-	GetCapsuleComponent()->SetCollisionProfileName("PlayerPawn");
-	
-	/** disable skeletal mesh gravity  */
-	GetMesh()->SetEnableGravity(false);
+	/** root collision  */
+	CollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionSphere"));
+	SetRootComponent(CollisionSphere);
+	CollisionSphere->SetSphereRadius(18.f);
+	CollisionSphere->SetEnableGravity(false);
+	CollisionSphere->SetCollisionProfileName("PlayerPawn");
+	CollisionSphere->CanCharacterStepUpOn = ECanBeCharacterBase::ECB_No;
 
 	/** wings scene */
 	Wings = CreateDefaultSubobject<USceneComponent>(TEXT("Wings"));
@@ -59,6 +67,10 @@ AGeo::AGeo()
 	Puck = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Puck"));
 	Puck->SetupAttachment(RootComponent);
 
+	/** cosmetic components, created everywhere so blueprints match the class,
+	*	a dedicated server destroys them in PostInitializeComponents
+	*/
+
 	/** emitter trail  */
 	Trail = CreateDefaultSubobject<UParticleSystemComponent>(TEXT("Trail"));
 	Trail->SetupAttachment(Puck);
@@ -74,106 +86,226 @@ AGeo::AGeo()
 	Reticle->SetupAttachment(ReticleLocation);
 	Reticle->SetRelativeScale3D(FVector(0.5f, 0.5f, 0.5f));
 
-	/** 2D flying movement setup  */
-	GetCharacterMovement()->BrakingDecelerationWalking = 2000.f;
-	GetCharacterMovement()->AirControl = 1.f;
-	GetCharacterMovement()->FallingLateralFriction = 1.f;
-	GetCharacterMovement()->MaxAcceleration = 1024.f;
-	GetCharacterMovement()->DefaultLandMovementMode = EMovementMode::MOVE_Flying;
-	GetCharacterMovement()->GroundFriction = 0.f;
-	GetCharacterMovement()->BrakingDecelerationFlying = 2000.f;
-	GetCharacterMovement()->BrakingDecelerationSwimming = 2000.f;
-	GetCharacterMovement()->NavAgentProps.AgentRadius = 18.f;
-	GetCharacterMovement()->NavAgentProps.AgentHeight = 36.f;
-	GetCharacterMovement()->bConstrainToPlane = true;
-	GetCharacterMovement()->bSnapToPlaneAtStart = true;
-	GetCharacterMovement()->SetPlaneConstraintNormal(FVector(0.f, 0.f, 1.f));
+	/** 2D plane movement setup  */
+	GeoMovement = CreateDefaultSubobject<UGeoMovementComponent>(TEXT("GeoMovement"));
+	GeoMovement->UpdatedComponent = CollisionSphere;
+	GeoMovement->MaxSpeed = 600.f;
+	GeoMovement->MaxAcceleration = 1024.f;
+	GeoMovement->BrakingDeceleration = 2000.f;
 
 #pragma region Helpers
 
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> WeaponWingsTemplate(TEXT("/Game/Player/Meshes/SM_Wing_Simple"));
-	if (WeaponWingsTemplate.Succeeded())
+	/** soft references, so the assets are streamed in with the map instead of loading with the class */
+	WeaponWingsMeshAsset = FSoftObjectPath(TEXT("/Game/Player/Meshes/SM_Wing_Simple.SM_Wing_Simple"));
+	PuckMeshAsset = FSoftObjectPath(TEXT("/Game/Player/Meshes/SM_PlayerCenter.SM_PlayerCenter"));
+	ProjectileTemplateAsset = FSoftObjectPath(TEXT("/Game/BP/BP_Projectile.BP_Projectile_C"));
+	CameraCurveAsset = FSoftObjectPath(TEXT("/Game/Player/Blueprint/CamCurve.CamCurve"));
+
+	if (!ShouldStripCosmetics())
 	{
-		WeaponWings->SetStaticMesh(WeaponWingsTemplate.Object);
+		TrailTemplateAsset = FSoftObjectPath(TEXT("/Game/Player/Particles/PFX_PlayerTrail.PFX_PlayerTrail"));
+		SparksTemplateAsset = FSoftObjectPath(TEXT("/Game/Weapons/Particles/PFX_WorldSparks.PFX_WorldSparks"));
+		ReticleMeshAsset = FSoftObjectPath(TEXT("/Game/Player/Meshes/SM_TargetMesh.SM_TargetMesh"));
+		FireSoundAsset = FSoftObjectPath(TEXT("/Game/Player/Audio/SimpleWeaponShot_Cue.SimpleWeaponShot_Cue"));
 	}
 
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> PuckTemplate(TEXT("/Game/Player/Meshes/SM_PlayerCenter"));
-	if (PuckTemplate.Succeeded())
+#pragma endregion
+
+
+	/** Geo defaults  */
+	bCanFire			= true;
+	bLeftMuzzle			= true;
+	bCanSwitchWeapon	= true;
+	bSparksShared		= false;
+	bSparksOwner		= false;
+}
+
+void AGeo::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (ShouldStripCosmetics())
 	{
-		Puck->SetStaticMesh(PuckTemplate.Object);
+		StripCosmeticComponent(Trail);
+		StripCosmeticComponent(Sparks);
+		StripCosmeticComponent(Reticle);
 	}
+}
+
+void AGeo::OnConstruction(const FTransform& Transform)
+{
+	ResolveDefaultAssets();
+
+	/** set default colors   */
+	WeaponColors.Empty();
+	WeaponColors.Add(FLinearColor::Red);
+	WeaponColors.Add(FLinearColor::Blue);
+	WeaponColors.Add(FLinearColor::Green);
+	WeaponColors.Add(FLinearColor::Yellow);
+
+	/** the last ones are the homing red and the explosive green  */
+	WeaponColors.Add(FLinearColor::Red);
+	WeaponColors.Add(FLinearColor::Green);
+	WeaponTypes.Init(EGeoWeaponType::Standard, WeaponColors.Num());
+	WeaponTypes[WeaponTypes.Num() - 2] = EGeoWeaponType::Homing;
+	WeaponTypes[WeaponTypes.Num() - 1] = EGeoWeaponType::Explosive;
+	
+	/** override colors in BP if needed  */
+	Super::OnConstruction(Transform);
 
-	static ConstructorHelpers::FObjectFinder<UParticleSystem> TrailTemplate(TEXT("/Game/Player/Particles/PFX_PlayerTrail"));
-	if (TrailTemplate.Succeeded())
+	/** set the wings color according to current weapon number and weapon color  */
+	SetWingsAndTrailColor();
+	
+	/** create a dynamic material for reticle  */
+	if (Reticle)
 	{
-		Trail->SetTemplate(TrailTemplate.Object);
+		SILLYGEO_LLM_SCOPE(DynamicMaterials);
+		ReticleDynamicMaterial = Reticle->CreateDynamicMaterialInstance(0);
 	}
+}
 
-	static ConstructorHelpers::FObjectFinder<UParticleSystem> SparksTemplate(TEXT("/Game/Weapons/Particles/PFX_WorldSparks"));
-	if (SparksTemplate.Succeeded())
+void AGeo::ResolveDefaultAssets()
+{
+	if (!WeaponWings->GetStaticMesh())
+	{
+		WeaponWings->SetStaticMesh(WeaponWingsMeshAsset.LoadSynchronous());
+	}
+	if (!Puck->GetStaticMesh())
+	{
+		Puck->SetStaticMesh(PuckMeshAsset.LoadSynchronous());
+	}
+	if (!ProjectileTemplate)
+	{
+		ProjectileTemplate = ProjectileTemplateAsset.LoadSynchronous();
+	}
+	if (!CameraCurve)
 	{
-		Sparks->SetTemplate(SparksTemplate.Object);
+		CameraCurve = CameraCurveAsset.LoadSynchronous();
 	}
 
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> ReticleTemplate(TEXT("/Game/Player/Meshes/SM_TargetMesh"));
-	if (ReticleTemplate.Succeeded())
+	/** cosmetic assets are never loaded on dedicated server, blueprints may set their paths too */
+	if (ShouldStripCosmetics()) { return; }
+
+	if (Trail && !Trail->Template)
+	{
+		Trail->SetTemplate(TrailTemplateAsset.LoadSynchronous());
+	}
+	if (Sparks && !Sparks->Template)
+	{
+		Sparks->SetTemplate(SparksTemplateAsset.LoadSynchronous());
+	}
+	if (Reticle && !Reticle->GetStaticMesh())
+	{
+		Reticle->SetStaticMesh(ReticleMeshAsset.LoadSynchronous());
+	}
+	if (!FireSound)
 	{
-		Reticle->SetStaticMesh(ReticleTemplate.Object);
+		FireSound = FireSoundAsset.LoadSynchronous();
 	}
+}
 
-	/** set projectile template class  */
-	static ConstructorHelpers::FClassFinder<AProjectile> ProjectileTemplateClass(TEXT("/Game/BP/BP_Projectile"));
-	if (ProjectileTemplateClass.Class)
+void AGeo::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	for (const FSoftObjectPath& Asset : { WeaponWingsMeshAsset.ToSoftObjectPath(), PuckMeshAsset.ToSoftObjectPath(),
+		CameraCurveAsset.ToSoftObjectPath(), ProjectileTemplateAsset.ToSoftObjectPath() })
+	{
+		if (Asset.IsValid())
+		{
+			OutAssets.AddUnique(Asset);
+		}
+	}
+	if (!ShouldStripCosmetics())
 	{
-		ProjectileTemplate = ProjectileTemplateClass.Class;
+		for (const FSoftObjectPath& Asset : { ReticleMeshAsset.ToSoftObjectPath(), TrailTemplateAsset.ToSoftObjectPath(), SparksTemplateAsset.ToSoftObjectPath(), FireSoundAsset.ToSoftObjectPath() })
+		{
+			if (Asset.IsValid())
+			{
+				OutAssets.AddUnique(Asset);
+			}
+		}
 	}
 
-	/** set fire sound  */
-	static ConstructorHelpers::FObjectFinder<USoundBase> FireSoundTemplate(TEXT("/Game/Player/Audio/SimpleWeaponShot_Cue"));
-	if (FireSoundTemplate.Succeeded())
+	/** the projectile blueprint isn't loaded yet, its native defaults name the same assets */
+	const UClass* ProjectileClass = ProjectileTemplate ? *ProjectileTemplate : ProjectileTemplateAsset.Get();
+	const AProjectile* ProjectileDefaults = ProjectileClass ? ProjectileClass->GetDefaultObject<AProjectile>() : GetDefault<AProjectile>();
+	ProjectileDefaults->GetPreloadAssets(OutAssets);
+}
+
+void AGeo::ApplyQualitySettings(const FGeoQualitySettings& Settings)
+{
+	SparksSpawnScale = Settings.SparksSpawnScale;
+	if (Sparks && SparksSpawnScale > 0.f)
 	{
-		FireSound = FireSoundTemplate.Object;
+		Sparks->SetFloatParameter("SpawnRateScale", SparksSpawnScale);
 	}
+	UpdateSparksActive();
 
-	/** set camera curve  */
-	static ConstructorHelpers::FObjectFinder<UCurveFloat> CameraCurveTemplate(TEXT("/Game/Player/Blueprint/CamCurve"));
-	if (CameraCurveTemplate.Succeeded())
+	if (Trail)
 	{
-		CameraCurve = CameraCurveTemplate.Object;
+		Trail->SetFloatParameter("SpawnRateScale", Settings.TrailSpawnScale);
 	}
+}
 
-#pragma endregion
+void AGeo::ShareWorldSparks(bool bOwner, const FVector& ViewsCenter)
+{
+	if (!Sparks) { return; }
 
+	if (!bSparksShared)
+	{
+		SparksOffset = Sparks->RelativeLocation;
+		bSparksShared = true;
+	}
+	bSparksOwner = bOwner;
 
-	/** Geo defaults  */
-	bCanFire			= true;
-	bLeftMuzzle			= true;
-	bCanSwitchWeapon	= true;
+	if (bSparksOwner)
+	{
+		if (!Sparks->bAbsoluteLocation)
+		{
+			Sparks->SetAbsolute(true, false, false);
+		}
+		Sparks->SetWorldLocation(ViewsCenter + SparksOffset);
+	}
+	UpdateSparksActive();
 }
 
-void AGeo::OnConstruction(const FTransform& Transform)
+void AGeo::StopSharingWorldSparks()
 {
-	/** set default colors   */
-	WeaponColors.Empty();
-	WeaponColors.Add(FLinearColor::Red);
-	WeaponColors.Add(FLinearColor::Blue);
-	WeaponColors.Add(FLinearColor::Green);
-	WeaponColors.Add(FLinearColor::Yellow);
-	
-	
-	/** override colors in BP if needed  */
-	Super::OnConstruction(Transform);
+	if (!Sparks || !bSparksShared) { return; }
 
-	/** set the wings color according to current weapon number and weapon color  */
-	SetWingsAndTrailColor();
-	
-	/** create a dynamic material for reticle  */
-	ReticleDynamicMaterial = Reticle->CreateDynamicMaterialInstance(0);
+	bSparksShared = false;
+	bSparksOwner = false;
+	Sparks->SetAbsolute(false, false, false);
+	Sparks->SetRelativeLocation(SparksOffset);
+	UpdateSparksActive();
+}
+
+void AGeo::UpdateSparksActive()
+{
+	if (!Sparks) { return; }
+
+	const bool bActive = SparksSpawnScale > 0.f && (!bSparksShared || bSparksOwner);
+	if (bActive && !Sparks->IsActive())
+	{
+		Sparks->Activate();
+	}
+	else if (!bActive && Sparks->IsActive())
+	{
+		Sparks->Deactivate();
+	}
 }
 
 void AGeo::SetWingsAndTrailColor()
 {
-	WingsDynamicMaterial = WeaponWings->CreateDynamicMaterialInstance(0);
+	/** nobody sees the wings on dedicated server  */
+	if (ShouldStripCosmetics())
+	{
+		return;
+	}
+
+	{
+		SILLYGEO_LLM_SCOPE(DynamicMaterials);
+		WingsDynamicMaterial = WeaponWings->CreateDynamicMaterialInstance(0);
+	}
 	if (WingsDynamicMaterial)
 	{
 		/** if something will wrong - use default gray color  */
@@ -187,7 +319,10 @@ void AGeo::SetWingsAndTrailColor()
 		WingsDynamicMaterial->SetVectorParameterValue("WingColor", ColorToSet);
 
 		/** set emitter trail color  */
-		Trail->SetColorParameter("TrailColor", ColorToSet);
+		if (Trail)
+		{
+			Trail->SetColorParameter("TrailColor", ColorToSet);
+		}
 	}
 }
 
@@ -196,6 +331,14 @@ void AGeo::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (const AGeoGameState* CurrentGameState = GetWorld()->GetGameState<AGeoGameState>())
+	{
+		if (const FGeoQualitySettings* Quality = CurrentGameState->GetQualitySettings())
+		{
+			ApplyQualitySettings(*Quality);
+		}
+	}
+
 	/** check wing list   */
 	if (!ensure(WingList.Num() != 0)) { return; }
 
@@ -206,9 +349,24 @@ void AGeo::BeginPlay()
 		PlayerController->bShowMouseCursor = true;
 		PlayerController->CurrentMouseCursor = EMouseCursor::Crosshairs;
 	}
-	if (!ensure(PlayerController)) { return; }
+	/** bots drive Geo without player controller  */
+	if (!ensure(Controller)) { return; }
 	
 	InitializePlayer();
+
+	StartInputCapture();
+}
+
+void AGeo::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (InputRecorder)
+	{
+		CaptureFrameTimes.Log(TEXT("Input recording"));
+		InputRecorder->Stop();
+		InputRecorder.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -235,20 +393,193 @@ void AGeo::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 	InputComponent->BindAxis("MovementY", this, &AGeo::MovementY);
 
 	// fire
-	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &AGeo::StartFire);
-	PlayerInputComponent->BindAction("Fire", IE_Released, this, &AGeo::StopFire);
+	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &AGeo::FirePressed);
+	PlayerInputComponent->BindAction("Fire", IE_Released, this, &AGeo::FireReleased);
 
 	// switch weapon
-	PlayerInputComponent->BindAction("NextWeapon", IE_Pressed, this, &AGeo::NextWeapon);
-	PlayerInputComponent->BindAction("PreviousWeapon", IE_Released, this, &AGeo::PreviousWeapon);
+	PlayerInputComponent->BindAction("NextWeapon", IE_Pressed, this, &AGeo::NextWeaponPressed);
+	PlayerInputComponent->BindAction("PreviousWeapon", IE_Released, this, &AGeo::PreviousWeaponPressed);
+}
+
+void AGeo::FirePressed()
+{
+	LiveInput.Buttons |= FGeoInputFrame::FireHeld;
+}
+
+void AGeo::FireReleased()
+{
+	LiveInput.Buttons &= ~FGeoInputFrame::FireHeld;
+}
+
+void AGeo::NextWeaponPressed()
+{
+	LiveInput.Buttons |= FGeoInputFrame::NextWeaponPressed;
+}
+
+void AGeo::PreviousWeaponPressed()
+{
+	LiveInput.Buttons |= FGeoInputFrame::PreviousWeaponPressed;
+}
+
+void AGeo::ProcessInputFrame()
+{
+	FGeoInputFrame Frame;
+	if (InputPlayer)
+	{
+		if (!InputPlayer->NextFrame(Frame))
+		{
+			FinishInputReplay();
+			return;
+		}
+	}
+	else
+	{
+		UpdateAimFromMouse();
+		Frame = LiveInput;
+		if (InputRecorder)
+		{
+			InputRecorder->Record(Frame);
+		}
+	}
+
+	/** dead Geo ignores the input  */
+	if (Health > 0.f)
+	{
+		ApplyInputFrame(Frame);
+	}
+
+	/** axes are sent by bindings every frame, pressed buttons are one frame events */
+	LiveInput.MoveX = 0;
+	LiveInput.MoveY = 0;
+	LiveInput.Buttons &= FGeoInputFrame::FireHeld;
+
+	if (InputPlayer || InputRecorder)
+	{
+		CaptureFrameTimes.Tick();
+	}
+}
+
+void AGeo::SetBotInput(const FGeoInputFrame& Frame)
+{
+	LiveInput = Frame;
+}
+
+void AGeo::RestoreState(const FVector& NewLocation, const FVector& NewVelocity, float NewHealth, int32 NewWeapon)
+{
+	SetActorLocation(NewLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	GeoMovement->Velocity = NewVelocity;
+	Health = FMath::Min(NewHealth, MaxHealth);
+
+	if (WeaponColors.IsValidIndex(NewWeapon) && NewWeapon != CurrentWeapon)
+	{
+		CurrentWeapon = NewWeapon;
+		SetWingsAndTrailColor();
+	}
+}
+
+void AGeo::ApplyInputFrame(const FGeoInputFrame& Frame)
+{
+	if (Frame.MoveX != 0)
+	{
+		AddMovementInput(FVector(FGeoInputFrame::DequantizeAxis(Frame.MoveX), 0.f, 0.f));
+	}
+	if (Frame.MoveY != 0)
+	{
+		AddMovementInput(FVector(0.f, -FGeoInputFrame::DequantizeAxis(Frame.MoveY), 0.f));
+	}
+
+	AimDirection = FVector(FGeoInputFrame::DequantizeAim(Frame.AimX), FGeoInputFrame::DequantizeAim(Frame.AimY), 0.f);
+
+	const bool bFireHeld = (Frame.Buttons & FGeoInputFrame::FireHeld) != 0;
+	const bool bWasFireHeld = (AppliedInput.Buttons & FGeoInputFrame::FireHeld) != 0;
+	if (bFireHeld && !bWasFireHeld)
+	{
+		StartFire();
+	}
+	else if (!bFireHeld && bWasFireHeld)
+	{
+		StopFire();
+	}
+
+	if (Frame.Buttons & FGeoInputFrame::NextWeaponPressed)
+	{
+		NextWeapon();
+	}
+	if (Frame.Buttons & FGeoInputFrame::PreviousWeaponPressed)
+	{
+		PreviousWeapon();
+	}
+
+	AppliedInput = Frame;
+}
+
+void AGeo::StartInputCapture()
+{
+	/** only standalone games are deterministic  */
+	if (!IsLocallyControlled() || GetNetMode() != NM_Standalone)
+	{
+		return;
+	}
+
+	FString Path;
+	if (FParse::Value(FCommandLine::Get(), TEXT("GeoReplay="), Path))
+	{
+		InputPlayer = MakeUnique<FGeoInputPlayer>();
+		if (!InputPlayer->Load(FGeoInputHeader::GetFullPath(Path)))
+		{
+			InputPlayer.Reset();
+		}
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("GeoRecord="), Path))
+	{
+		/** the replay runs with the same fixed step and seed  */
+		FGeoInputHeader Header;
+		if (const ASillyGeoGameMode* GeoGameMode = GetWorld()->GetAuthGameMode<ASillyGeoGameMode>())
+		{
+			Header.StepRate = GeoGameMode->GetFixedStepRate();
+			Header.Seed = GeoGameMode->GetSimulationSeed();
+		}
+
+		InputRecorder = MakeUnique<FGeoInputRecorder>();
+		if (!InputRecorder->Start(FGeoInputHeader::GetFullPath(Path), Header))
+		{
+			InputRecorder.Reset();
+		}
+	}
+}
+
+void AGeo::FinishInputReplay()
+{
+	UE_LOG(LogTemp, Log, TEXT("Input replay finished"));
+	CaptureFrameTimes.Log(TEXT("Input replay"));
+	InputPlayer.Reset();
+	StopFire();
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("GeoReplayExit")))
+	{
+		FPlatformMisc::RequestExit(false);
+	}
 }
 
 float AGeo::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	if (bInvulnerable)
+	{
+		return 0.f;
+	}
+
 	const float ActualDamage = Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
 	if (ActualDamage > 0.f)
 	{
 		Health -= ActualDamage;
+
+		if (const ASillyGeoGameMode* GeoGameMode = GetWorld()->GetAuthGameMode<ASillyGeoGameMode>())
+		{
+			if (FGeoTelemetry* Telemetry = GeoGameMode->GetTelemetry())
+			{
+				Telemetry->Push(EGeoTelemetryEvent::GeoDamaged, PlayerState ? PlayerState->PlayerId : INDEX_NONE, NAME_None, ActualDamage, Health);
+			}
+		}
 		
 		// we are dead
 		if (Health <= 0.f)
@@ -340,7 +671,7 @@ void AGeo::InitializePlayer()
 	{
 		PC = TestPC;
 	}
-	if (!ensure(PC)) { return; }
+	if (!ensure(Controller)) { return; }
 
 	/** set game state reference  */
 	if (AGeoGameState* TestGeoGameState = Cast<AGeoGameState>(GetWorld()->GetGameState()))
@@ -351,8 +682,11 @@ void AGeo::InitializePlayer()
 
 	/** reset health  */
 	Health = MaxHealth;
-	EnableInput(PC);
-	PC->EnableInput(PC);
+	if (PC)
+	{
+		EnableInput(PC);
+		PC->EnableInput(PC);
+	}
 		
 	/** start regeneration timer */
 	GetWorldTimerManager().SetTimer(RegenTimer, this, &AGeo::RegenerateHealth, RegenerationDelay, true);
@@ -384,21 +718,33 @@ void AGeo::StopFire()
 
 void AGeo::Fire()
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_GeoFire, GeoFire);
+
 	if (ProjectileTemplate)
 	{
 		UWorld* const World = GetWorld();
 		if (World)
 		{
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Owner = this;
-			SpawnParams.Instigator = Instigator;
-			
-			FTransform SpawnTransform = bLeftMuzzle ? WeaponWings->GetSocketTransform("Weapon_A") : WeaponWings->GetSocketTransform("Weapon_B");
+			FTransform MuzzleTransform = bLeftMuzzle ? WeaponWings->GetSocketTransform("Weapon_A") : WeaponWings->GetSocketTransform("Weapon_B");
 
+			/** shots are replicated as compact events, every machine simulates its own projectile */
+			const float ServerTime = World->GetGameState() ? World->GetGameState()->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+			const FGeoFireEvent FireEvent = FGeoFireEvent::Make(ServerTime, MuzzleTransform.GetLocation(), MuzzleTransform.Rotator().Yaw, CurrentWeapon, bLeftMuzzle, GetVelocity().X);
 			
-			AProjectile* SpawnedProjectile = World->SpawnActor<AProjectile>(ProjectileTemplate, SpawnTransform, SpawnParams);
+			AProjectile* SpawnedProjectile = SpawnProjectile(FireEvent, 0.f);
 			if (SpawnedProjectile)
 			{
+				if (HasAuthority())
+				{
+					SendFireToRelevantClients(FireEvent);
+				}
+				else
+				{
+					NextShotId = NextShotId == MAX_uint8 ? 1 : NextShotId + 1;
+					SpawnedProjectile->SetShotId(NextShotId);
+					ServerFire(FireEvent, NextShotId);
+				}
+
 				/** cooldown  */
 				bCanFire = false;
 				FTimerDelegate CooldownDelegate;
@@ -424,40 +770,251 @@ void AGeo::Fire()
 	}
 }
 
-void AGeo::MovementX(float Value)
+AProjectile* AGeo::SpawnProjectile(const FGeoFireEvent& FireEvent, float FastForwardTime)
 {
-	if (Value != 0.f)
+	UWorld* const World = GetWorld();
+	if (!World || !ProjectileTemplate) { return nullptr; }
+
+	/** we are on the plane, so muzzle height is the same on every machine  */
+	const float MuzzleHeight = WeaponWings->GetSocketLocation(FireEvent.IsLeftMuzzle() ? "Weapon_A" : "Weapon_B").Z;
+	const FTransform SpawnTransform(FRotator(0.f, FireEvent.GetYaw(), 0.f), FireEvent.GetOrigin(MuzzleHeight));
+
+	SILLYGEO_LLM_SCOPE(Projectiles);
+	AProjectile* SpawnedProjectile = World->SpawnActorDeferred<AProjectile>(ProjectileTemplate, SpawnTransform, this, Instigator);
+	if (SpawnedProjectile)
 	{
-		AddMovementInput(FVector(Value, 0.f, 0.f));
+		SILLYGEO_FRAME_EVENT(ProjectileSpawned);
+
+		/** projectiles hurt enemies on the server only if the shooter is local to the server,
+		*	remote shooters report their hits with ReportHit
+		*/
+		const bool bDealsDamage = HasAuthority() && IsLocallyControlled();
+		SpawnedProjectile->InitProjectile(FireEvent.GetWeapon(), GetWeaponColor(FireEvent.GetWeapon()), FireEvent.GetInheritedSpeed(), bDealsDamage);
+		SpawnedProjectile->FinishSpawning(SpawnTransform);
+
+		/** catch up with the shooter  */
+		if (FastForwardTime > 0.f && !SpawnedProjectile->IsPendingKill())
+		{
+			SpawnedProjectile->FastForward(FMath::Min(FastForwardTime, MaxFireFastForward));
+		}
 	}
+	return SpawnedProjectile;
 }
 
-void AGeo::MovementY(float Value)
+float AGeo::GetFireEventAge(const FGeoFireEvent& FireEvent) const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (!GameState) { return 0.f; }
+
+	const float ServerTime = GameState->GetServerWorldTimeSeconds();
+	return FMath::Max(ServerTime - FireEvent.GetFireTime(ServerTime), 0.f);
+}
+
+bool AGeo::ServerFire_Validate(FGeoFireEvent FireEvent, uint8 ShotId)
+{
+	return WeaponColors.IsValidIndex(FireEvent.GetWeapon());
+}
+
+void AGeo::ServerFire_Implementation(FGeoFireEvent FireEvent, uint8 ShotId)
 {
-	if (Value != 0.f)
+	/** don't trust the muzzle too far from where we think the client is  */
+	if ((FireEvent.GetOrigin(0.f) - GetActorLocation()).SizeSquared2D() > FMath::Square(MaxFireOriginError))
+	{
+		return;
+	}
+
+	/** don't trust the client cooldown either  */
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextServerFireTime - FireRateJitter)
 	{
-		AddMovementInput(FVector(0.f, -Value, 0.f));
+		return;
+	}
+	NextServerFireTime = FMath::Max(Now, NextServerFireTime) + FireRate;
+
+	const float FastForwardTime = FMath::Min(GetFireEventAge(FireEvent), MaxFireFastForward);
+	const AProjectile* const SpawnedProjectile = SpawnProjectile(FireEvent, FastForwardTime);
+	if (!SpawnedProjectile)
+	{
+		return;
+	}
+	SendFireToRelevantClients(FireEvent);
+
+	/** remember the path of the shot to validate its hit  */
+	if (ShotId != 0)
+	{
+		const AGameStateBase* const GameState = GetWorld()->GetGameState();
+		const FVector Velocity = SpawnedProjectile->GetVelocity();
+
+		FGeoShotRecord Shot;
+		Shot.ShotId = ShotId;
+		Shot.Weapon = (uint8)FireEvent.GetWeapon();
+		Shot.bHoming = GetWeaponType(FireEvent.GetWeapon()) == EGeoWeaponType::Homing;
+		Shot.FireTime = (GameState ? GameState->GetServerWorldTimeSeconds() : Now) - FastForwardTime;
+		Shot.Origin = FVector2D(FireEvent.GetOrigin(0.f));
+		Shot.Direction = FVector2D(Velocity).GetSafeNormal();
+		Shot.Speed = Velocity.Size2D();
+
+		/** a shot with the same id is one that wrapped around or a replay, the old one is dropped */
+		ServerShots.RemoveAll([ShotId](const FGeoShotRecord& Other) { return Other.ShotId == ShotId; });
+		ServerShots.Add(Shot);
+	}
+}
+
+bool AGeo::ConsumeShotRecord(uint8 ShotId, FGeoShotRecord& OutShot)
+{
+	const AGameStateBase* const GameState = GetWorld()->GetGameState();
+	const float ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	/** drop stale shots, they are kept the oldest first  */
+	int32 Stale = 0;
+	while (Stale < ServerShots.Num() && ServerTime - ServerShots[Stale].FireTime > MaxShotConfirmAge)
+	{
+		Stale++;
+	}
+	ServerShots.RemoveAt(0, Stale, false);
+
+	const int32 Index = ServerShots.IndexOfByPredicate([ShotId](const FGeoShotRecord& Shot) { return Shot.ShotId == ShotId; });
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	/** one confirm per shot, whether it passes or not  */
+	OutShot = ServerShots[Index];
+	ServerShots.RemoveAt(Index, 1, false);
+	return true;
+}
+
+void AGeo::ReportHit(class AEnemyBase* Enemy, const FVector& HitLocation, uint8 ShotId)
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (Enemy && GameState && ShotId != 0)
+	{
+		ServerConfirmHit(Enemy->GetNetId(), GameState->GetServerWorldTimeSeconds(), HitLocation, ShotId);
+	}
+}
+
+bool AGeo::ServerConfirmHit_Validate(int32 EnemyId, float HitTime, FVector_NetQuantize HitLocation, uint8 ShotId)
+{
+	return FMath::IsFinite(HitTime);
+}
+
+void AGeo::ServerConfirmHit_Implementation(int32 EnemyId, float HitTime, FVector_NetQuantize HitLocation, uint8 ShotId)
+{
+	/** only a shot we have seen, once  */
+	FGeoShotRecord Shot;
+	if (!ConsumeShotRecord(ShotId, Shot))
+	{
+		INC_DWORD_STAT(STAT_RejectedHits);
+		return;
+	}
+	const int32 Weapon = Shot.Weapon;
+
+	AGeoGameState* const GameState = GetWorld()->GetGameState<AGeoGameState>();
+	AEnemyBase* const Enemy = GameState ? GameState->FindEnemy(EnemyId) : nullptr;
+	if (!Enemy || Enemy->GetEnemyColor() != GetWeaponColor(Weapon) || !ProjectileTemplate)
+	{
+		return;
+	}
+
+	/** the hit must be on the path of the shot, no farther than the shot could fly by now */
+	const AProjectile* const ProjectileDefaults = ProjectileTemplate->GetDefaultObject<AProjectile>();
+	const float HitRadius = Enemy->GetHitRadius() + ProjectileDefaults->GetCollisionRadius() + HitValidationTolerance;
+	const float ReachTime = FMath::Clamp(HitTime, Shot.FireTime, GameState->GetServerWorldTimeSeconds());
+	if (!Shot.CanReach(FVector2D(HitLocation), ReachTime, HitRadius))
+	{
+		INC_DWORD_STAT(STAT_RejectedHits);
+		return;
+	}
+
+	/** rewind the enemy to the time of the hit and check it was there  */
+	if (GameState->ValidateEnemyHit(EnemyId, HitTime, HitLocation, HitRadius))
+	{
+		ASillyGeoGameMode* const GameMode = GetWorld()->GetAuthGameMode<ASillyGeoGameMode>();
+		if (GetWeaponType(Weapon) == EGeoWeaponType::Explosive && GameMode)
+		{
+			/** the blast goes off where the enemy is now, that is where the index has it */
+			GameMode->ResolveBlast(Enemy->GetActorLocation(), ProjectileDefaults->GetBlastRadius(), ProjectileDefaults->GetBlastDamage(), Enemy->GetColorType(), GetController());
+		}
+		else
+		{
+			Enemy->TakeDamage(ProjectileDefaults->GetDamageToCause(), FDamageEvent(), GetController(), this);
+		}
 	}
 }
 
+void AGeo::SendFireToRelevantClients(const FGeoFireEvent& FireEvent)
+{
+	const AGeoGameState* GeoGameState = GetWorld()->GetGameState<AGeoGameState>();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		AGeoPlayerController* GeoPC = Cast<AGeoPlayerController>(Iterator->Get());
+
+		/** shooter and server have already spawned this shot  */
+		if (!GeoPC || GeoPC == GetController() || GeoPC->IsLocalController())
+		{
+			continue;
+		}
+
+		const APawn* ViewPawn = GeoPC->GetPawn();
+		if (!GeoGameState || !ViewPawn || GeoGameState->IsRelevantLocation(ViewPawn->GetActorLocation(), FireEvent.GetOrigin(0.f)))
+		{
+			GeoPC->ClientSimulateFire(this, FireEvent);
+		}
+	}
+}
+
+void AGeo::SimulateRemoteFire(const FGeoFireEvent& FireEvent)
+{
+	if (!IsLocallyControlled())
+	{
+		SpawnProjectile(FireEvent, GetFireEventAge(FireEvent));
+	}
+}
+
+void AGeo::MovementX(float Value)
+{
+	LiveInput.MoveX = FGeoInputFrame::QuantizeAxis(Value);
+}
+
+void AGeo::MovementY(float Value)
+{
+	LiveInput.MoveY = FGeoInputFrame::QuantizeAxis(Value);
+}
+
 void AGeo::ZoomCamera()
 {
 	if (CameraCurve)
 	{
-		float Alpha = CameraCurve->GetFloatValue(GetCharacterMovement()->Velocity.Size() / GetCharacterMovement()->MaxFlySpeed);
+		float Alpha = CameraCurve->GetFloatValue(GeoMovement->Velocity.Size() / GeoMovement->GetMaxSpeed());
 		PlayerCamera->SetRelativeLocation(FVector(0.f, 0.f, FMath::Lerp(0.f, CameraZoomMax, Alpha)));
 	}
 }
 
-void AGeo::RotateToMouseCursor(float DeltaTime)
+void AGeo::UpdateAimFromMouse()
 {
 	if (PlayerController)
 	{
 		float MouseX, MouseY;
 		FVector WorldLocation, WorldDirection;
 
-		PlayerController->GetMousePosition(MouseX, MouseY);
-		PlayerController->DeprojectScreenPositionToWorld(MouseX, MouseY, WorldLocation, WorldDirection);
+		if (PlayerController->GetMousePosition(MouseX, MouseY) && PlayerController->DeprojectScreenPositionToWorld(MouseX, MouseY, WorldLocation, WorldDirection))
+		{
+			LiveInput.AimX = FGeoInputFrame::QuantizeAim(WorldDirection.X);
+			LiveInput.AimY = FGeoInputFrame::QuantizeAim(WorldDirection.Y);
+		}
+	}
+}
+
+void AGeo::RotateToMouseCursor(float DeltaTime)
+{
+	SILLYGEO_SCOPE_COUNTER(STAT_GeoRotateToMouseCursor, GeoRotateToMouseCursor);
+
+	/** player or bot  */
+	if (Controller)
+	{
+		const FVector WorldDirection = AimDirection;
 
 		/** setup reticle location and opacity */
 		float RoughtStickMagnitude = FMath::Max(FMath::Abs(WorldDirection.X), FMath::Abs(WorldDirection.Y));
@@ -483,11 +1040,21 @@ void AGeo::RotateToMouseCursor(float DeltaTime)
 	}
 }
 
+UPawnMovementComponent* AGeo::GetMovementComponent() const
+{
+	return GeoMovement;
+}
+
 FLinearColor AGeo::GetCurrentWeaponColor() const
 {
-	if (WeaponColors.IsValidIndex(CurrentWeapon))
+	return GetWeaponColor(CurrentWeapon);
+}
+
+FLinearColor AGeo::GetWeaponColor(int32 Weapon) const
+{
+	if (WeaponColors.IsValidIndex(Weapon))
 	{
-		return WeaponColors[CurrentWeapon];
+		return WeaponColors[Weapon];
 	}
 	else
 	{
@@ -3,15 +3,39 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameFramework/Character.h"
+#include "GameFramework/Pawn.h"
 #include "Curves/CurveFloat.h"
+#include "GeoFireEvent.h"
+#include "GeoInputRecording.h"
 #include "Geo.generated.h"
 
+/** how projectiles of a weapon fly  */
+UENUM(BlueprintType)
+enum class EGeoWeaponType : uint8
+{
+	/** straight from the muzzle  */
+	Standard,
+
+	/** steer to the nearest enemy of the weapon color  */
+	Homing,
+
+	/** damage every enemy of the weapon color around the impact  */
+	Explosive
+};
+
 UCLASS()
-class SILLYGEO_API AGeo : public ACharacter
+class SILLYGEO_API AGeo : public APawn
 {
 	GENERATED_BODY()
 
+	/** root collision sphere  */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	class USphereComponent* CollisionSphere;
+
+	/** 2D plane movement  */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	class UGeoMovementComponent* GeoMovement;
+
 	/** players wings scene  */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	class USceneComponent* Wings;
@@ -64,6 +88,31 @@ class SILLYGEO_API AGeo : public ACharacter
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	UCurveFloat* CameraCurve;
 
+	/** wing, puck and reticle meshes, FX, fire sound and camera curve, used where the blueprint sets none */
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UStaticMesh> WeaponWingsMeshAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UStaticMesh> PuckMeshAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UStaticMesh> ReticleMeshAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UParticleSystem> TrailTemplateAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UParticleSystem> SparksTemplateAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class USoundBase> FireSoundAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<UCurveFloat> CameraCurveAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftClassPtr<class AProjectile> ProjectileTemplateAsset;
+
 	
 public:
 
@@ -74,16 +123,74 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	FLinearColor GetCurrentWeaponColor() const;
 
+	/** returns the color of specified weapon  */
+	UFUNCTION(BlueprintCallable, Category = "AAA")
+	FLinearColor GetWeaponColor(int32 Weapon) const;
+
+	/** returns the type of specified weapon  */
+	UFUNCTION(BlueprintCallable, Category = "AAA")
+	EGeoWeaponType GetWeaponType(int32 Weapon) const { return WeaponTypes.IsValidIndex(Weapon) ? WeaponTypes[Weapon] : EGeoWeaponType::Standard; }
+
+	/** [client] calls when the server tells us about the shot of this Geo  */
+	void SimulateRemoteFire(const FGeoFireEvent& FireEvent);
+
+	/** [client] calls when our local projectile hits replicated enemy, the server validates the hit
+	*	against where the enemy was at the time of the hit
+	*/
+	void ReportHit(class AEnemyBase* Enemy, const FVector& HitLocation, uint8 ShotId);
+
+	/** returns our 2D movement component  */
+	virtual class UPawnMovementComponent* GetMovementComponent() const override;
+
+	/** [tick] calls by player controller once input bindings have fired,
+	*	applies the input of this frame (live or replayed) and records it
+	*/
+	void ProcessInputFrame();
+
+	/** calls by bot controller instead of input bindings, before ProcessInputFrame  */
+	void SetBotInput(const FGeoInputFrame& Frame);
+
+	/** calls to make Geo ignore all damage, used by benchmark bots  */
+	void SetInvulnerable(bool bNewInvulnerable) { bInvulnerable = bNewInvulnerable; }
+
+	/** calls to put Geo back into the state of an arena snapshot  */
+	void RestoreState(const FVector& NewLocation, const FVector& NewVelocity, float NewHealth, int32 NewWeapon);
+
+	/** adds default assets of Geo and its projectiles to preload  */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** scales sparks and trail spawn rates to the quality tier  */
+	void ApplyQualitySettings(const struct FGeoQualitySettings& Settings);
+
+	/** [split-screen] one world sparks emitter serves a group of overlapping local views: the owner moves
+	*	its sparks under the center of the group Geos, sparks of other Geos of the group are off
+	*/
+	void ShareWorldSparks(bool bOwner, const FVector& ViewsCenter);
+
+	/** puts the sparks back under own camera  */
+	void StopSharingWorldSparks();
+
 protected:
 	
-	// Sets default values for this character's properties
+	// Sets default values for this pawn's properties
 	AGeo();
 
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	/** destroys cosmetic components on a dedicated server  */
+	virtual void PostInitializeComponents() override;
+
+	/** fills empty components and properties with default assets, they are loaded already
+	*	if the game mode has preloaded them, otherwise they are loaded right now
+	*/
+	void ResolveDefaultAssets();
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	/** finishes input recording  */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
@@ -108,10 +215,28 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void ZoomCamera();
 	
-	/** [tick] calls to rotate weapon to mouse cursor  */
+	/** [tick] calls to rotate weapon to aim direction  */
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void RotateToMouseCursor(float DeltaTime);
 
+	/** calls to deproject mouse cursor into aim direction of live input  */
+	void UpdateAimFromMouse();
+
+	/** input bindings, they only fill live input of this frame  */
+	void FirePressed();
+	void FireReleased();
+	void NextWeaponPressed();
+	void PreviousWeaponPressed();
+
+	/** calls to drive Geo by the input of one frame  */
+	void ApplyInputFrame(const FGeoInputFrame& Frame);
+
+	/** starts input recording ( -GeoRecord=File ) or replay ( -GeoReplay=File ) */
+	void StartInputCapture();
+
+	/** calls when the whole recording is played, -GeoReplayExit quits the game then */
+	void FinishInputReplay();
+
 	/** calls to set wings and trail color according to current weapon */
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void SetWingsAndTrailColor();
@@ -148,6 +273,30 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void Fire();
 
+	/** calls to spawn local projectile simulating the shot
+	*	@param FastForwardTime - how far (in sec) to move the projectile along its path right away
+	*/
+	class AProjectile* SpawnProjectile(const FGeoFireEvent& FireEvent, float FastForwardTime);
+
+	/** returns how long ago the shot was made according to the server clock  */
+	float GetFireEventAge(const FGeoFireEvent& FireEvent) const;
+
+	/** client -> server : our shot, unreliable as a lost shot is just a shot nobody saw
+	*	@param ShotId - the number of the shot its hit is confirmed with, 0 is never used
+	*/
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerFire(FGeoFireEvent FireEvent, uint8 ShotId);
+
+	/** [server] sends the shot to every other player near the shooter  */
+	void SendFireToRelevantClients(const FGeoFireEvent& FireEvent);
+
+	/** client -> server : the projectile of our shot ShotId hit the enemy at specified server time  */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerConfirmHit(int32 EnemyId, float HitTime, FVector_NetQuantize HitLocation, uint8 ShotId);
+
+	/** [server] removes and returns the record of specified shot, false for unknown and stale shots */
+	bool ConsumeShotRecord(uint8 ShotId, FGeoShotRecord& OutShot);
+
 	// -----------------------------------------------------------------------------------
 	
 	/** interp rotation speed from current wings rotation to reticle */
@@ -196,6 +345,19 @@ private:
 	*/
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	uint32 bLeftMuzzle : 1;
+
+	/** [split-screen] world sparks are shared between local Geos, and this one owns them */
+	uint32 bSparksShared : 1;
+	uint32 bSparksOwner : 1;
+
+	/** sparks spawn scale of the quality tier  */
+	float SparksSpawnScale = 1.f;
+
+	/** sparks location relative to the camera root  */
+	FVector SparksOffset = FVector::ZeroVector;
+
+	/** activates sparks if the quality tier and sharing allow them  */
+	void UpdateSparksActive();
 	
 	/** dynamic material for player wings  */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
@@ -209,6 +371,10 @@ private:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true", EditCondition = "!bUseDefaultColors"))
 	TArray<FLinearColor> WeaponColors;
 
+	/** the type of every weapon of WeaponColors, missing ones are standard */
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	TArray<EGeoWeaponType> WeaponTypes;
+
 	/** the number of current weapon
 	*   some other player stuff depends on this parameter
 	*   e.g. wings color, trail color, projectile color and weapon type
@@ -228,6 +394,10 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	float MaxHealth = 200.f;
 
+	/** if true, Geo ignores all damage  */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	bool bInvulnerable = false;
+
 	/** player controller reference  */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	class APlayerController* PC;
@@ -240,7 +410,63 @@ private:
 	UPROPERTY()
 	FTimerHandle RegenTimer;
 
+	/** live input gathered by input bindings this frame  */
+	FGeoInputFrame LiveInput;
+
+	/** the last applied input frame  */
+	FGeoInputFrame AppliedInput;
+
+	/** the direction we aim to, X/Y of mouse deprojection  */
+	FVector AimDirection = FVector::ZeroVector;
+
+	/** records our input  */
+	TUniquePtr<FGeoInputRecorder> InputRecorder;
+
+	/** replays recorded input instead of live one  */
+	TUniquePtr<FGeoInputPlayer> InputPlayer;
+
+	/** frame times while recording or replaying  */
+	FGeoFrameTimes CaptureFrameTimes;
+
+	/** the max age (in sec) of the shot we still fast forward, older shots are simulated from "now" */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float MaxFireFastForward = 0.3f;
+
+	/** extra distance (in uu) added to enemy and projectile radius when the server validates client hits */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float HitValidationTolerance = 16.f;
+
+	/** the max distance between client and server muzzle location the server accepts */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float MaxFireOriginError = 200.f;
+
+	/** how much earlier (in sec) than FireRate allows the server still accepts a shot, for packets that arrive bunched */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float FireRateJitter = 0.05f;
+
+	/** [server] the earliest time the next shot of the remote shooter is due, early shots are credited
+	*	against it, so the sustained rate never exceeds FireRate
+	*/
+	float NextServerFireTime = 0.f;
+
+	/** how long (in sec) after the shot its hit may be confirmed, covers the life span of homing shots */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float MaxShotConfirmAge = 4.f;
+
+	/** the number of our next shot, wraps skipping 0  */
+	uint8 NextShotId = 0;
+
+	/** [server] shots of the remote shooter whose hits aren't confirmed yet, the oldest first */
+	TArray<FGeoShotRecord> ServerShots;
+
 public:
 
+	/** returns Geo movement component **/
+	FORCEINLINE class UGeoMovementComponent* GetGeoMovement() const { return GeoMovement; }
+
+	/** returns current health **/
+	FORCEINLINE float GetHealth() const { return Health; }
 
+	/** returns the number of current weapon **/
+	FORCEINLINE int32 GetCurrentWeapon() const { return CurrentWeapon; }
 };
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoArenaSnapshot.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+uint16 FGeoArenaSnapshot::GetClassIndex(const UClass* Class)
+{
+	return (uint16)Classes.AddUnique(Class ? Class->GetPathName() : FString());
+}
+
+FArchive& operator<<(FArchive& Ar, FGeoArenaSnapshot& Snapshot)
+{
+	Ar << Snapshot.Magic << Snapshot.Version;
+
+	/** don't read the rest of a foreign file  */
+	if (Ar.IsLoading() && (Snapshot.Magic != FGeoArenaSnapshot::FileMagic || Snapshot.Version != FGeoArenaSnapshot::FileVersion))
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Snapshot.MapName;
+	Ar << Snapshot.CurrentWave << Snapshot.EnemiesRemaining << Snapshot.bWaveActive;
+	Ar << Snapshot.EnemyToSpawn << Snapshot.EnemiesSpawned << Snapshot.SpawnedOfType;
+	Ar << Snapshot.SpawnTimerRemaining << Snapshot.WaveTimerRemaining;
+	Ar << Snapshot.Classes;
+	Ar << Snapshot.Enemies << Snapshot.Projectiles << Snapshot.Geos;
+	return Ar;
+}
+
+bool FGeoArenaSnapshot::Save(const FString& Path)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	Writer << *this;
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't write arena snapshot %s"), *Path);
+		return false;
+	}
+	return true;
+}
+
+bool FGeoArenaSnapshot::Load(const FString& Path)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't read arena snapshot %s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	Reader << *this;
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s isn't a valid arena snapshot"), *Path);
+		return false;
+	}
+	return true;
+}
+
+FString FGeoArenaSnapshot::GetFullPath(const FString& Name)
+{
+	if (Name.Contains(TEXT("/")) || Name.Contains(TEXT("\\")))
+	{
+		return FPaths::IsRelative(Name) ? FPaths::Combine(FPaths::ProjectSavedDir(), Name) : Name;
+	}
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Snapshots"), Name + TEXT(".geosnap"));
+}
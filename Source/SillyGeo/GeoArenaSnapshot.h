@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** state of one live enemy  */
+struct FGeoEnemySnapshot
+{
+	/** index into snapshot class table  */
+	uint16 ClassIndex = 0;
+
+	/** enemies live on the plane, so 2D is enough  */
+	FVector2D Location = FVector2D::ZeroVector;
+	FVector2D Velocity = FVector2D::ZeroVector;
+	float Yaw = 0.f;
+
+	float Health = 0.f;
+
+	/** EEnemyColor  */
+	uint8 Color = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FGeoEnemySnapshot& Enemy)
+	{
+		return Ar << Enemy.ClassIndex << Enemy.Location << Enemy.Velocity << Enemy.Yaw << Enemy.Health << Enemy.Color;
+	}
+};
+
+/** state of one live projectile  */
+struct FGeoProjectileSnapshot
+{
+	/** index into snapshot class table  */
+	uint16 ClassIndex = 0;
+
+	/** index of the shooter in snapshot Geos, INDEX_NONE if the shooter is gone */
+	int8 OwnerIndex = INDEX_NONE;
+
+	/** projectiles fly at muzzle height, so we keep Z  */
+	FVector Location = FVector::ZeroVector;
+	float Yaw = 0.f;
+
+	uint8 Weapon = 0;
+	FLinearColor Color = FLinearColor::Black;
+	float InheritedSpeed = 0.f;
+
+	friend FArchive& operator<<(FArchive& Ar, FGeoProjectileSnapshot& Projectile)
+	{
+		return Ar << Projectile.ClassIndex << Projectile.OwnerIndex << Projectile.Location << Projectile.Yaw
+			<< Projectile.Weapon << Projectile.Color << Projectile.InheritedSpeed;
+	}
+};
+
+/** state of one player Geo, stored in player controller order  */
+struct FGeoPawnSnapshot
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	float Health = 0.f;
+	uint8 Weapon = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FGeoPawnSnapshot& Geo)
+	{
+		return Ar << Geo.Location << Geo.Velocity << Geo.Health << Geo.Weapon;
+	}
+};
+
+/**
+*	the whole combat state of the arena: wave counters, spawn cursor, enemies, projectiles and Geos.
+*	Classes are stored once in the class table and referenced by index, so the blob stays compact
+*	( ~30 bytes per enemy, ~40 bytes per projectile )
+*/
+struct SILLYGEO_API FGeoArenaSnapshot
+{
+	static constexpr uint32 FileMagic = 0x53414547; // "GEAS"
+	static constexpr uint16 FileVersion = 1;
+
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+
+	/** the map the snapshot was taken on  */
+	FString MapName;
+
+	/** game state counters  */
+	int32 CurrentWave = 0;
+	int32 EnemiesRemaining = 0;
+	bool bWaveActive = false;
+
+	/** game mode spawn cursor  */
+	int32 EnemyToSpawn = 0;
+	int32 EnemiesSpawned = 0;
+	TArray<int32> SpawnedOfType;
+
+	/** remaining time of game mode timers, negative if the timer isn't active */
+	float SpawnTimerRemaining = -1.f;
+	float WaveTimerRemaining = -1.f;
+
+	/** class paths referenced by enemies and projectiles  */
+	TArray<FString> Classes;
+
+	TArray<FGeoEnemySnapshot> Enemies;
+	TArray<FGeoProjectileSnapshot> Projectiles;
+	TArray<FGeoPawnSnapshot> Geos;
+
+	/** returns the index of specified class in class table, adds it if needed */
+	uint16 GetClassIndex(const UClass* Class);
+
+	friend FArchive& operator<<(FArchive& Ar, FGeoArenaSnapshot& Snapshot);
+
+	/** writes the snapshot to specified file  */
+	bool Save(const FString& Path);
+
+	/** reads the snapshot from specified file, returns false if it isn't a valid snapshot */
+	bool Load(const FString& Path);
+
+	/** snapshot names are resolved to Saved/Snapshots/<Name>.geosnap, paths are used as is */
+	static FString GetFullPath(const FString& Name);
+};
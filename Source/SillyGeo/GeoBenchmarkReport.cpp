@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoBenchmarkReport.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FGeoBenchmarkPercentiles FGeoBenchmarkPercentiles::Compute(const TArray<float>& Samples)
+{
+	FGeoBenchmarkPercentiles Result;
+	if (Samples.Num() == 0) { return Result; }
+
+	TArray<float> Sorted = Samples;
+	Sorted.Sort();
+
+	auto Percentile = [&Sorted](float P) { return Sorted[FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)]; };
+
+	double Sum = 0.0;
+	for (float Sample : Sorted)
+	{
+		Sum += Sample;
+	}
+
+	Result.Avg = (float)(Sum / Sorted.Num());
+	Result.P50 = Percentile(0.5f);
+	Result.P90 = Percentile(0.9f);
+	Result.P99 = Percentile(0.99f);
+	Result.Max = Sorted.Last();
+	return Result;
+}
+
+FGeoBenchmarkWave& FGeoBenchmarkReport::BeginWave(int32 Wave, int32 Enemies)
+{
+	FGeoBenchmarkWave& NewWave = Waves[Waves.AddDefaulted()];
+	NewWave.Wave = Wave;
+	NewWave.Enemies = Enemies;
+	NewWave.CounterTotalsMs.SetNumZeroed(CounterNames.Num());
+	NewWave.QualityTierSeconds.SetNumZeroed(QualityTierNames.Num());
+	return NewWave;
+}
+
+bool FGeoBenchmarkReport::Write(const FString& Name, const FString& MapName) const
+{
+	const FString BasePath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("Benchmark"), Name);
+
+	const bool bCsv = FFileHelper::SaveStringToFile(ToCsv(), *(BasePath + TEXT(".csv")));
+	const bool bJson = FFileHelper::SaveStringToFile(ToJson(MapName), *(BasePath + TEXT(".json")));
+	if (!bCsv || !bJson)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't write benchmark report %s"), *BasePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Benchmark report written to %s.csv / .json"), *BasePath);
+	return true;
+}
+
+FString FGeoBenchmarkReport::ToCsv() const
+{
+	FString Csv = TEXT("Views,Wave,Enemies,Frames,Seconds,")
+		TEXT("FrameAvgMs,FrameP50Ms,FrameP90Ms,FrameP99Ms,FrameMaxMs,")
+		TEXT("GameThreadAvgMs,GameThreadP50Ms,GameThreadP90Ms,GameThreadP99Ms,GameThreadMaxMs,")
+		TEXT("RenderThreadAvgMs,RenderThreadP99Ms,")
+		TEXT("MaxEnemies,MaxProjectiles,MaxActors,UsedPhysicalMB,PeakUsedPhysicalMB");
+	for (const FString& CounterName : CounterNames)
+	{
+		Csv += FString::Printf(TEXT(",%sAvgMs"), *CounterName);
+	}
+	for (const FString& TierName : QualityTierNames)
+	{
+		Csv += FString::Printf(TEXT(",Quality%sSeconds"), *TierName);
+	}
+	Csv += TEXT("\n");
+
+	for (const FGeoBenchmarkWave& Wave : Waves)
+	{
+		const FGeoBenchmarkPercentiles Frame = FGeoBenchmarkPercentiles::Compute(Wave.FrameTimes);
+		const FGeoBenchmarkPercentiles GameThread = FGeoBenchmarkPercentiles::Compute(Wave.GameThreadTimes);
+		const FGeoBenchmarkPercentiles RenderThread = FGeoBenchmarkPercentiles::Compute(Wave.RenderThreadTimes);
+
+		Csv += FString::Printf(TEXT("%d,%d,%d,%d,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%.1f,%.1f"),
+			Views, Wave.Wave, Wave.Enemies, Wave.FrameTimes.Num(), Wave.Duration,
+			Frame.Avg, Frame.P50, Frame.P90, Frame.P99, Frame.Max,
+			GameThread.Avg, GameThread.P50, GameThread.P90, GameThread.P99, GameThread.Max,
+			RenderThread.Avg, RenderThread.P99,
+			Wave.MaxEnemies, Wave.MaxProjectiles, Wave.MaxActors, Wave.UsedPhysicalMB, Wave.PeakUsedPhysicalMB);
+		for (int32 Counter = 0; Counter < CounterNames.Num(); Counter++)
+		{
+			Csv += FString::Printf(TEXT(",%.4f"), Wave.GetCounterAvgMs(Counter));
+		}
+		for (int32 Tier = 0; Tier < QualityTierNames.Num(); Tier++)
+		{
+			Csv += FString::Printf(TEXT(",%.2f"), Wave.QualityTierSeconds.IsValidIndex(Tier) ? Wave.QualityTierSeconds[Tier] : 0.0);
+		}
+		Csv += TEXT("\n");
+	}
+	return Csv;
+}
+
+FString FGeoBenchmarkReport::ToJson(const FString& MapName) const
+{
+	auto PercentilesToJson = [](const FGeoBenchmarkPercentiles& P)
+	{
+		return FString::Printf(TEXT("{ \"avg\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f }"), P.Avg, P.P50, P.P90, P.P99, P.Max);
+	};
+
+	FString Json = FString::Printf(TEXT("{\n\t\"map\": \"%s\",\n\t\"views\": %d,\n\t\"waves\": [\n"), *MapName, Views);
+	for (int32 i = 0; i < Waves.Num(); i++)
+	{
+		const FGeoBenchmarkWave& Wave = Waves[i];
+
+		Json += FString::Printf(TEXT("\t\t{ \"wave\": %d, \"enemies\": %d, \"frames\": %d, \"seconds\": %.2f,\n"), Wave.Wave, Wave.Enemies, Wave.FrameTimes.Num(), Wave.Duration);
+		Json += FString::Printf(TEXT("\t\t\t\"frame_ms\": %s,\n"), *PercentilesToJson(FGeoBenchmarkPercentiles::Compute(Wave.FrameTimes)));
+		Json += FString::Printf(TEXT("\t\t\t\"game_thread_ms\": %s,\n"), *PercentilesToJson(FGeoBenchmarkPercentiles::Compute(Wave.GameThreadTimes)));
+		Json += FString::Printf(TEXT("\t\t\t\"render_thread_ms\": %s,\n"), *PercentilesToJson(FGeoBenchmarkPercentiles::Compute(Wave.RenderThreadTimes)));
+		if (CounterNames.Num() > 0)
+		{
+			FString Breakdown;
+			for (int32 Counter = 0; Counter < CounterNames.Num(); Counter++)
+			{
+				Breakdown += FString::Printf(TEXT("%s\"%s\": %.4f"), Counter > 0 ? TEXT(", ") : TEXT(""), *CounterNames[Counter], Wave.GetCounterAvgMs(Counter));
+			}
+			Json += FString::Printf(TEXT("\t\t\t\"game_thread_breakdown_avg_ms\": { %s },\n"), *Breakdown);
+		}
+		if (QualityTierNames.Num() > 0)
+		{
+			FString Tiers;
+			for (int32 Tier = 0; Tier < QualityTierNames.Num(); Tier++)
+			{
+				Tiers += FString::Printf(TEXT("%s\"%s\": %.2f"), Tier > 0 ? TEXT(", ") : TEXT(""), *QualityTierNames[Tier], Wave.QualityTierSeconds.IsValidIndex(Tier) ? Wave.QualityTierSeconds[Tier] : 0.0);
+			}
+			Json += FString::Printf(TEXT("\t\t\t\"quality_tier_seconds\": { %s },\n"), *Tiers);
+		}
+		Json += FString::Printf(TEXT("\t\t\t\"max_enemies\": %d, \"max_projectiles\": %d, \"max_actors\": %d,\n"), Wave.MaxEnemies, Wave.MaxProjectiles, Wave.MaxActors);
+		Json += FString::Printf(TEXT("\t\t\t\"used_physical_mb\": %.1f, \"peak_used_physical_mb\": %.1f }%s\n"), Wave.UsedPhysicalMB, Wave.PeakUsedPhysicalMB, i < Waves.Num() - 1 ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t]\n}\n");
+	return Json;
+}
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** p50 / p90 / p99 / max / average of one per-frame value  */
+struct FGeoBenchmarkPercentiles
+{
+	float Avg = 0.f;
+	float P50 = 0.f;
+	float P90 = 0.f;
+	float P99 = 0.f;
+	float Max = 0.f;
+
+	static FGeoBenchmarkPercentiles Compute(const TArray<float>& Samples);
+};
+
+/** everything we measured during one wave  */
+struct FGeoBenchmarkWave
+{
+	int32 Wave = 0;
+
+	/** enemies the wave table spawns this wave  */
+	int32 Enemies = 0;
+
+	/** per-frame times in ms  */
+	TArray<float> FrameTimes;
+	TArray<float> GameThreadTimes;
+	TArray<float> RenderThreadTimes;
+
+	/** game thread breakdown: ms spent in every named gameplay scope, summed over all frames */
+	TArray<double> CounterTotalsMs;
+
+	/** wall time (in sec) spent in every quality tier  */
+	TArray<double> QualityTierSeconds;
+
+	/** live actor counts, sampled a few times a second  */
+	int32 MaxEnemies = 0;
+	int32 MaxProjectiles = 0;
+	int32 MaxActors = 0;
+
+	/** used physical memory at the end of the wave and the peak during the wave, in MB */
+	float UsedPhysicalMB = 0.f;
+	float PeakUsedPhysicalMB = 0.f;
+
+	/** wall time of the wave in seconds  */
+	double Duration = 0.0;
+
+	/** returns average ms per frame spent in specified counter  */
+	float GetCounterAvgMs(int32 Counter) const
+	{
+		return CounterTotalsMs.IsValidIndex(Counter) && FrameTimes.Num() > 0 ? (float)(CounterTotalsMs[Counter] / FrameTimes.Num()) : 0.f;
+	}
+};
+
+/**
+*	benchmark results of the whole run, one row per wave.
+*	Written as CSV (easy to diff between builds) and JSON (easy to feed dashboards)
+*/
+class SILLYGEO_API FGeoBenchmarkReport
+{
+public:
+
+	/** starts measuring the next wave  */
+	FGeoBenchmarkWave& BeginWave(int32 Wave, int32 Enemies);
+
+	/** sets the names of game thread breakdown counters  */
+	void SetCounterNames(const TArray<FString>& Names) { CounterNames = Names; }
+
+	/** sets how many split-screen views rendered the run, render thread times are totals of all views */
+	void SetViews(int32 InViews) { Views = FMath::Max(InViews, 1); }
+
+	/** sets the names of quality tiers, the best one first  */
+	void SetQualityTierNames(const TArray<FString>& Names) { QualityTierNames = Names; }
+
+	/** returns the wave we measure right now, nullptr before the first wave */
+	FGeoBenchmarkWave* GetCurrentWave() { return Waves.Num() > 0 ? &Waves.Last() : nullptr; }
+
+	/** writes Name.csv and Name.json into Saved/Profiling/Benchmark  */
+	bool Write(const FString& Name, const FString& MapName) const;
+
+	const TArray<FGeoBenchmarkWave>& GetWaves() const { return Waves; }
+
+private:
+
+	FString ToCsv() const;
+	FString ToJson(const FString& MapName) const;
+
+	TArray<FGeoBenchmarkWave> Waves;
+
+	/** game thread breakdown counters  */
+	TArray<FString> CounterNames;
+
+	/** quality tiers  */
+	TArray<FString> QualityTierNames;
+
+	/** split-screen views  */
+	int32 Views = 1;
+};
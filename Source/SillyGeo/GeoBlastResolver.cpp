@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoBlastResolver.h"
+#include "GeoEnemySpatialIndex.h"
+#include "EnemyBase.h"
+
+void FGeoBlastResolver::Resolve(const FGeoEnemySpatialIndex& EnemyIndex, const FVector& Location, float Radius, float Damage, EEnemyColor Color, TArray<AEnemyBase*>& OutKilled)
+{
+	const uint8 ColorMask = FGeoEnemySpatialIndex::ColorBit(Color);
+
+	Blasts.Reset();
+	Blasts.Add({ Location, Radius, Damage, 0 });
+
+	/** chain blasts are appended while we go  */
+	for (int32 i = 0; i < Blasts.Num(); i++)
+	{
+		const FBlast Blast = Blasts[i];
+
+		Victims.Reset();
+		EnemyIndex.QueryRadius(Blast.Location, Blast.Radius, ColorMask, Victims);
+
+		for (AEnemyBase* Enemy : Victims)
+		{
+			/** enemies killed earlier in the batch are still indexed, but take no more damage */
+			if (!Enemy->ApplyBatchDamage(Blast.Damage))
+			{
+				continue;
+			}
+
+			OutKilled.Add(Enemy);
+			if (Blast.Depth < MaxChainDepth && ChainRadius > 0.f)
+			{
+				Blasts.Add({ Enemy->GetActorLocation(), ChainRadius, ChainDamage, Blast.Depth + 1 });
+			}
+		}
+	}
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AEnemyBase;
+class FGeoEnemySpatialIndex;
+enum class EEnemyColor : uint8;
+
+/**
+*	[server] resolves area damage of explosive weapons in one batch: victims of every blast are gathered
+*	with one enemy index query, damage is subtracted in a tight loop without TakeDamage, and every enemy
+*	killed by the batch explodes again (a chain blast) up to MaxChainDepth times.
+*	Killed enemies are only collected, the caller reports them and destroys them once per batch
+*/
+class SILLYGEO_API FGeoBlastResolver
+{
+public:
+
+	/** applies the blast and chain blasts of enemies it kills to enemies of Color,
+	*	adds killed enemies to OutKilled in the order they died
+	*/
+	void Resolve(const FGeoEnemySpatialIndex& EnemyIndex, const FVector& Location, float Radius, float Damage, EEnemyColor Color, TArray<AEnemyBase*>& OutKilled);
+
+	/** radius (in uu) of the blast of a killed enemy, 0 - no chain reactions  */
+	float ChainRadius = 300.f;
+
+	/** damage of the blast of a killed enemy  */
+	float ChainDamage = 50.f;
+
+	/** how many times chain blasts may cause next chain blasts  */
+	int32 MaxChainDepth = 3;
+
+private:
+
+	struct FBlast
+	{
+		FVector Location;
+		float Radius;
+		float Damage;
+		int32 Depth;
+	};
+
+	/** blasts of the batch, resolved in order, kept for the next batch  */
+	TArray<FBlast> Blasts;
+
+	/** victims of one blast  */
+	TArray<AEnemyBase*> Victims;
+};
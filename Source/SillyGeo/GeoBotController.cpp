@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoBotController.h"
+#include "Geo.h"
+#include "EnemyBase.h"
+#include "EngineUtils.h"
+
+AGeoBotController::AGeoBotController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	/** kills are counted on the player state  */
+	bWantsPlayerState = true;
+}
+
+void AGeoBotController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	AGeo* Geo = Cast<AGeo>(GetPawn());
+	if (!Geo || Geo->GetHealth() <= 0.f) { return; }
+
+	const FVector GeoLocation = Geo->GetActorLocation();
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now >= NextRetargetTime || !Target || Target->IsPendingKill())
+	{
+		UpdateTarget(GeoLocation);
+		NextRetargetTime = Now + RetargetInterval;
+	}
+
+	FGeoInputFrame Frame;
+	if (Target)
+	{
+		const FVector ToTarget = (Target->GetActorLocation() - GeoLocation) * FVector(1.f, 1.f, 0.f);
+		const FVector AimDirection = ToTarget.GetSafeNormal();
+		Frame.AimX = FGeoInputFrame::QuantizeAim(AimDirection.X);
+		Frame.AimY = FGeoInputFrame::QuantizeAim(AimDirection.Y);
+
+		/** only projectiles of the enemy color hurt it  */
+		if (Geo->GetCurrentWeaponColor() == Target->GetEnemyColor())
+		{
+			Frame.Buttons |= FGeoInputFrame::FireHeld;
+		}
+		else
+		{
+			Frame.Buttons |= FGeoInputFrame::NextWeaponPressed;
+		}
+
+		/** back off when it is too close, strafe around it otherwise */
+		const FVector MoveDirection = ToTarget.SizeSquared() < FMath::Square(KeepAwayDistance) ? -AimDirection : FVector(-AimDirection.Y, AimDirection.X, 0.f) * 0.5f;
+		Frame.MoveX = FGeoInputFrame::QuantizeAxis(MoveDirection.X);
+		Frame.MoveY = FGeoInputFrame::QuantizeAxis(-MoveDirection.Y);
+	}
+
+	Geo->SetBotInput(Frame);
+	Geo->ProcessInputFrame();
+}
+
+void AGeoBotController::UpdateTarget(const FVector& GeoLocation)
+{
+	Target = nullptr;
+
+	float BestDistanceSquared = MAX_flt;
+	for (TActorIterator<AEnemyBase> It(GetWorld()); It; ++It)
+	{
+		if (It->IsPendingKill() || It->IsWarmUp()) { continue; }
+
+		const float DistanceSquared = FVector::DistSquared2D(It->GetActorLocation(), GeoLocation);
+		if (DistanceSquared < BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			Target = *It;
+		}
+	}
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "GeoBotController.generated.h"
+
+/**
+*	drives Geo through the same input frames the player produces: aims at the nearest enemy,
+*	switches weapon to match its color, fires and keeps some distance
+*/
+UCLASS()
+class SILLYGEO_API AGeoBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+
+	AGeoBotController();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+
+	/** calls to pick the nearest enemy as a target  */
+	void UpdateTarget(const FVector& GeoLocation);
+
+	/** the enemy we shoot at  */
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	class AEnemyBase* Target;
+
+	/** how often (in sec) we look for the nearest enemy  */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float RetargetInterval = 0.2f;
+
+	/** we back off from enemies closer than this  */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float KeepAwayDistance = 400.f;
+
+	/** the time we look for the nearest enemy again  */
+	float NextRetargetTime = 0.f;
+};
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoEnemySpatialIndex.h"
+#include "EnemyBase.h"
+#include "SillyGeoStats.h"
+
+void FGeoEnemySpatialIndex::Init(float NewCellSize)
+{
+	Entries.Empty();
+	Grid.Init(NewCellSize);
+}
+
+void FGeoEnemySpatialIndex::ReadEnemy(FEntry& Entry)
+{
+	Entry.Location = FVector2D(Entry.Enemy->GetActorLocation());
+	Entry.ColorBit = ColorBit(Entry.Enemy->GetColorType());
+}
+
+int32 FGeoEnemySpatialIndex::Add(AEnemyBase* Enemy)
+{
+	if (!Enemy) { return INDEX_NONE; }
+
+	FEntry Entry;
+	Entry.Enemy = Enemy;
+	ReadEnemy(Entry);
+	Entry.Cell = Grid.GetCell(Entry.Location);
+
+	const int32 Handle = Entries.Add(Entry);
+	Grid.Add(Handle, Entry.Cell);
+	return Handle;
+}
+
+void FGeoEnemySpatialIndex::Remove(int32& Handle)
+{
+	if (Entries.IsValidIndex(Handle))
+	{
+		Grid.Remove(Handle, Entries[Handle].Cell);
+		Entries.RemoveAt(Handle);
+	}
+	Handle = INDEX_NONE;
+}
+
+void FGeoEnemySpatialIndex::Update()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyIndexUpdate);
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		FEntry& Entry = *It;
+		ReadEnemy(Entry);
+
+		/** most enemies stay in their cell from frame to frame  */
+		const FIntPoint NewCell = Grid.GetCell(Entry.Location);
+		if (NewCell != Entry.Cell)
+		{
+			Grid.Move(It.GetIndex(), Entry.Cell, NewCell);
+			Entry.Cell = NewCell;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_IndexedEnemies, Entries.Num());
+}
+
+void FGeoEnemySpatialIndex::QueryRadius(const FVector& Location, float Radius, uint8 ColorMask, TArray<AEnemyBase*>& OutEnemies) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyIndexQuery);
+
+	if (Entries.Num() == 0 || Radius <= 0.f) { return; }
+
+	const FVector2D Center(Location);
+	const float RadiusSq = FMath::Square(Radius);
+	const FIntPoint MinCell = Grid.GetCell(Center - FVector2D(Radius, Radius));
+	const FIntPoint MaxCell = Grid.GetCell(Center + FVector2D(Radius, Radius));
+	Grid.ForEachInRect(MinCell, MaxCell, [&](int32 Handle, const FIntPoint&)
+	{
+		const FEntry& Entry = Entries[Handle];
+		if ((Entry.ColorBit & ColorMask) && FVector2D::DistSquared(Entry.Location, Center) <= RadiusSq)
+		{
+			OutEnemies.Add(Entry.Enemy);
+		}
+	});
+}
+
+void FGeoEnemySpatialIndex::QueryNearest(const FVector& Location, int32 K, float MaxRadius, uint8 ColorMask, TArray<AEnemyBase*>& OutEnemies) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyIndexQuery);
+
+	if (Entries.Num() == 0 || K <= 0 || MaxRadius <= 0.f) { return; }
+
+	/** K best so far, sorted by distance  */
+	TArray<TPair<float, AEnemyBase*>, TInlineAllocator<8>> Nearest;
+	const FVector2D Center(Location);
+	const FIntPoint CenterCell = Grid.GetCell(Center);
+	const float CellSize = Grid.GetCellSize();
+	const float MaxRadiusSq = FMath::Square(MaxRadius);
+
+	/** rings of cells around the center, every enemy of the ring N + 1 is at least N cells away,
+	*	so we stop once we have K enemies closer than that
+	*/
+	const int32 MaxRing = FMath::CeilToInt(MaxRadius / CellSize);
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		Grid.ForEachInRing(CenterCell, Ring, [&](int32 Handle, const FIntPoint&)
+		{
+			const FEntry& Entry = Entries[Handle];
+			if (!(Entry.ColorBit & ColorMask)) { return; }
+
+			const float DistSq = FVector2D::DistSquared(Entry.Location, Center);
+			if (DistSq > MaxRadiusSq || (Nearest.Num() == K && DistSq >= Nearest.Last().Key)) { return; }
+
+			if (Nearest.Num() == K)
+			{
+				Nearest.Pop(false);
+			}
+			int32 Insert = Nearest.Num();
+			while (Insert > 0 && Nearest[Insert - 1].Key > DistSq)
+			{
+				Insert--;
+			}
+			Nearest.Insert(TPair<float, AEnemyBase*>(DistSq, Entry.Enemy), Insert);
+		});
+
+		if (Nearest.Num() == K && Nearest.Last().Key <= FMath::Square(Ring * CellSize))
+		{
+			break;
+		}
+	}
+
+	for (const TPair<float, AEnemyBase*>& Pair : Nearest)
+	{
+		OutEnemies.Add(Pair.Value);
+	}
+}
+
+AEnemyBase* FGeoEnemySpatialIndex::FindNearest(const FVector& Location, float MaxRadius, uint8 ColorMask) const
+{
+	TArray<AEnemyBase*> Nearest;
+	QueryNearest(Location, 1, MaxRadius, ColorMask, Nearest);
+	return Nearest.Num() > 0 ? Nearest[0] : nullptr;
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeoInterestGrid.h"
+
+class AEnemyBase;
+enum class EEnemyColor : uint8;
+
+/**
+*	live enemies bucketed by uniform cells of the arena plane (Z is ignored), so gameplay
+*	can ask "which enemies are near this point" without physics overlaps.
+*	Enemies keep their slot for the whole life, Update moves a slot to another bucket
+*	only when the enemy crosses a cell, and queries look only at the cells around the point,
+*	so their cost depends on the local density and not on the total number of enemies
+*/
+class SILLYGEO_API FGeoEnemySpatialIndex
+{
+public:
+
+	/** color mask that matches every enemy  */
+	static const uint8 AnyColor = 0xFF;
+
+	/** returns the color mask bit of specified enemy color  */
+	static uint8 ColorBit(EEnemyColor Color) { return (uint8)(1 << (uint8)Color); }
+
+	/** calls to set the cell size (in uu) and drop all enemies  */
+	void Init(float NewCellSize);
+
+	/** adds the enemy at its current location, returns the handle to update / remove it with */
+	int32 Add(AEnemyBase* Enemy);
+
+	/** removes the enemy with specified handle, the handle is reset to INDEX_NONE */
+	void Remove(int32& Handle);
+
+	/** [tick] refreshes locations and colors, enemies that crossed a cell change their buckets */
+	void Update();
+
+	/** returns the number of enemies in the index  */
+	int32 Num() const { return Entries.Num(); }
+
+	/** adds enemies of ColorMask within Radius from Location to OutEnemies, in no particular order */
+	void QueryRadius(const FVector& Location, float Radius, uint8 ColorMask, TArray<AEnemyBase*>& OutEnemies) const;
+
+	/** adds up to K nearest enemies of ColorMask within MaxRadius from Location to OutEnemies, the nearest first */
+	void QueryNearest(const FVector& Location, int32 K, float MaxRadius, uint8 ColorMask, TArray<AEnemyBase*>& OutEnemies) const;
+
+	/** returns the nearest enemy of ColorMask within MaxRadius from Location, nullptr if there is none */
+	AEnemyBase* FindNearest(const FVector& Location, float MaxRadius, uint8 ColorMask) const;
+
+private:
+
+	struct FEntry
+	{
+		/** enemies remove themselves in EndPlay, so the pointer is valid while the entry exists */
+		AEnemyBase* Enemy = nullptr;
+		FVector2D Location = FVector2D::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		uint8 ColorBit = 0;
+	};
+
+	/** reads location and color of the entry's enemy  */
+	static void ReadEnemy(FEntry& Entry);
+
+	/** enemy slots, handles are indices in this array  */
+	TSparseArray<FEntry> Entries;
+
+	/** handles of enemies bucketed by cell  */
+	FGeoInterestGrid Grid;
+};
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeoFireEvent.generated.h"
+
+/**
+*	one shot of Geo, replicated instead of the projectile actor.
+*	Every machine spawns its own local projectile from the event, so all the
+*	fields are stored quantized: the shooter simulates exactly the same
+*	shot as everybody else. 10 bytes on the wire
+*/
+USTRUCT()
+struct FGeoFireEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** uu per quantized origin unit  */
+	static constexpr float OriginScale = 2.f;
+
+	/** uu/s per quantized inherited speed unit  */
+	static constexpr float InheritedSpeedScale = 4.f;
+
+	/** server time of the shot in ms, wrapped to 16 bits ( ~65 sec )  */
+	UPROPERTY()
+	uint16 TimeMs = 0;
+
+	/** quantized 2D muzzle location  */
+	UPROPERTY()
+	int16 OriginX = 0;
+
+	UPROPERTY()
+	int16 OriginY = 0;
+
+	/** quantized direction yaw  */
+	UPROPERTY()
+	uint16 Yaw = 0;
+
+	/** 4 bits weapon, 1 bit muzzle  */
+	UPROPERTY()
+	uint8 WeaponAndMuzzle = 0;
+
+	/** quantized owner speed added to projectile speed  */
+	UPROPERTY()
+	uint8 InheritedSpeed = 0;
+
+	/** makes quantized event  */
+	static FGeoFireEvent Make(float ServerTime, const FVector& Origin, float DirectionYaw, int32 Weapon, bool bLeftMuzzle, float OwnerSpeed)
+	{
+		FGeoFireEvent Event;
+		Event.TimeMs = (uint16)((int64)(ServerTime * 1000.f) & 0xFFFF);
+		Event.OriginX = (int16)FMath::Clamp(FMath::RoundToInt(Origin.X / OriginScale), -MAX_int16, (int32)MAX_int16);
+		Event.OriginY = (int16)FMath::Clamp(FMath::RoundToInt(Origin.Y / OriginScale), -MAX_int16, (int32)MAX_int16);
+		Event.Yaw = FRotator::CompressAxisToShort(DirectionYaw);
+		Event.WeaponAndMuzzle = (uint8)(Weapon & 0x0F) | (bLeftMuzzle ? 0x10 : 0);
+		Event.InheritedSpeed = (uint8)FMath::Clamp(FMath::RoundToInt(FMath::Abs(OwnerSpeed) / InheritedSpeedScale), 0, (int32)MAX_uint8);
+		return Event;
+	}
+
+	/** returns the server time of this shot, ServerTime is current server time  */
+	float GetFireTime(float ServerTime) const
+	{
+		const uint16 NowMs = (uint16)((int64)(ServerTime * 1000.f) & 0xFFFF);
+		const uint16 AgeMs = NowMs - TimeMs;
+		return ServerTime - AgeMs / 1000.f;
+	}
+
+	/** returns muzzle location at specified height  */
+	FVector GetOrigin(float Z) const { return FVector(OriginX * OriginScale, OriginY * OriginScale, Z); }
+
+	/** returns direction yaw  */
+	float GetYaw() const { return FRotator::DecompressAxisFromShort(Yaw); }
+
+	/** returns weapon number  */
+	int32 GetWeapon() const { return WeaponAndMuzzle & 0x0F; }
+
+	/** returns true if shot was made from left muzzle  */
+	bool IsLeftMuzzle() const { return (WeaponAndMuzzle & 0x10) != 0; }
+
+	/** returns owner speed to add to projectile speed  */
+	float GetInheritedSpeed() const { return InheritedSpeed * InheritedSpeedScale; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		Ar << TimeMs;
+		Ar << OriginX;
+		Ar << OriginY;
+		Ar << Yaw;
+		Ar << WeaponAndMuzzle;
+		Ar << InheritedSpeed;
+		bOutSuccess = true;
+		return true;
+	}
+};
+
+/**
+*	[server] a shot of a remote shooter the server has accepted. The client numbers its shots,
+*	the server keeps what it saw of them and confirms at most one hit per shot on its path
+*/
+struct FGeoShotRecord
+{
+	uint8 ShotId = 0;
+	uint8 Weapon = 0;
+
+	/** homing shots may turn anywhere within the distance they flew  */
+	bool bHoming = false;
+
+	/** server time of the shot  */
+	float FireTime = 0.f;
+
+	FVector2D Origin = FVector2D::ZeroVector;
+	FVector2D Direction = FVector2D::ZeroVector;
+
+	/** projectile speed in uu/s  */
+	float Speed = 0.f;
+
+	/** returns true if the projectile of this shot could be within Tolerance from Location at Time */
+	bool CanReach(const FVector2D& Location, float Time, float Tolerance) const
+	{
+		const FVector2D ToLocation = Location - Origin;
+		const float Reach = Speed * FMath::Max(Time - FireTime, 0.f) + Tolerance;
+		if (bHoming)
+		{
+			return ToLocation.SizeSquared() <= FMath::Square(Reach);
+		}
+
+		const float Along = ToLocation | Direction;
+		const float Across = FMath::Abs(ToLocation ^ Direction);
+		return Along >= -Tolerance && Along <= Reach && Across <= Tolerance;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FGeoFireEvent> : public TStructOpsTypeTraitsBase2<FGeoFireEvent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
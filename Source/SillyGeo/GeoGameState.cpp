@@ -2,6 +2,148 @@
 
 #include "GeoGameState.h"
 #include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "EnemyBase.h"
+#include "SillyGeoStats.h"
+#include "GeoPlayerState.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "EngineUtils.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/App.h"
+#include "Geo.h"
+#include "Projectile.h"
+#include "SillyGeoGameMode.h"
+
+AGeoGameState::AGeoGameState()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	/** default quality tiers  */
+	QualityTiers.SetNum(4);
+	QualityTiers[0].Name = TEXT("High");
+
+	QualityTiers[1].Name = TEXT("Medium");
+	QualityTiers[1].SparksSpawnScale = 0.5f;
+	QualityTiers[1].ProjectileTrailSpawnScale = 0.5f;
+	QualityTiers[1].MaxExplosionsPerSecond = 30;
+	QualityTiers[1].MaxEntities = 400;
+
+	QualityTiers[2].Name = TEXT("Low");
+	QualityTiers[2].SparksSpawnScale = 0.25f;
+	QualityTiers[2].TrailSpawnScale = 0.5f;
+	QualityTiers[2].ProjectileTrailSpawnScale = 0.25f;
+	QualityTiers[2].MaxExplosionsPerSecond = 15;
+	QualityTiers[2].bProjectileLights = false;
+	QualityTiers[2].MaxEntities = 800;
+
+	QualityTiers[3].Name = TEXT("Minimal");
+	QualityTiers[3].SparksSpawnScale = 0.f;
+	QualityTiers[3].TrailSpawnScale = 0.25f;
+	QualityTiers[3].ProjectileTrailSpawnScale = 0.f;
+	QualityTiers[3].MaxExplosionsPerSecond = 5;
+	QualityTiers[3].bProjectileLights = false;
+	QualityTiers[3].bEnemyPulse = false;
+}
+
+void AGeoGameState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	ReplicatedEnemies.Owner = this;
+
+	/** before any enemy begins play  */
+	EnemyIndex.Init(EnemyIndexCellSize);
+}
+
+void AGeoGameState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority() && GetNetMode() != NM_Standalone)
+	{
+		EnemyHistory.Init(LagCompensationWindow, LagCompensationSampleRate);
+	}
+	InterestGrid.Init(InterestCellSize);
+
+	/** every world that plays has a game state, so clients capture their own hitches */
+	float ThresholdMs = HitchThresholdMs;
+	const bool bThresholdOverride = FParse::Value(FCommandLine::Get(), TEXT("GeoHitchMs="), ThresholdMs);
+	if (bDetectHitches || bThresholdOverride)
+	{
+		HitchDetector = MakeUnique<FGeoHitchDetector>();
+		HitchDetector->ThresholdMs = ThresholdMs;
+		HitchDetector->MinCaptureInterval = MinHitchCaptureInterval;
+		HitchDetector->MaxCaptures = MaxHitchCaptures;
+		HitchDetector->Start(HitchFramesToCapture);
+	}
+
+	/** nothing is rendered on a dedicated server  */
+	if (bGovernQuality && GetNetMode() != NM_DedicatedServer)
+	{
+		QualityGovernor = MakeUnique<FGeoQualityGovernor>();
+		QualityGovernor->TargetFrameMs = QualityTargetFrameMs;
+		QualityGovernor->Init(QualityTiers);
+	}
+
+	PreloadClientAssets();
+}
+
+void AGeoGameState::ReceivedGameModeClass()
+{
+	Super::ReceivedGameModeClass();
+
+	/** the initial bunch may bring the class before BeginPlay, PreloadClientAssets waits for it */
+	if (HasActorBegunPlay())
+	{
+		PreloadClientAssets();
+	}
+}
+
+void AGeoGameState::PreloadClientAssets()
+{
+	/** the server game mode preloads for the server and its local players  */
+	if (GetNetMode() != NM_Client || PreloadHandle.IsValid()) { return; }
+
+	const ASillyGeoGameMode* GameModeDefaults = Cast<ASillyGeoGameMode>(GetDefaultGameMode());
+	if (!GameModeDefaults) { return; }
+
+	TArray<FSoftObjectPath> Assets;
+	GameModeDefaults->GetPreloadAssets(Assets);
+	if (Assets.Num() == 0) { return; }
+
+	PreloadStartTime = FPlatformTime::Seconds();
+	PreloadHandle = StreamableManager.RequestAsyncLoad(Assets, FStreamableDelegate::CreateUObject(this, &AGeoGameState::OnClientAssetsPreloaded), FStreamableManager::AsyncLoadHighPriority);
+	UE_LOG(LogTemp, Log, TEXT("Client: preloading %d assets"), Assets.Num());
+}
+
+void AGeoGameState::OnClientAssetsPreloaded()
+{
+	UE_LOG(LogTemp, Log, TEXT("Client: assets preloaded in %.3f s"), FPlatformTime::Seconds() - PreloadStartTime);
+}
+
+void AGeoGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	/** waits for the capture being written  */
+	HitchDetector.Reset();
+
+	if (QualityGovernor)
+	{
+		QualityGovernor->LogTierTimes();
+		QualityGovernor.Reset();
+	}
+
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->ReleaseHandle();
+		PreloadHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
 void AGeoGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
@@ -9,7 +151,725 @@ void AGeoGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 
 	DOREPLIFETIME(AGeoGameState, EnemiesRemaining);
 	DOREPLIFETIME(AGeoGameState, bWaveActive);
-	DOREPLIFETIME(AGeoGameState, WaveDelay);
-	DOREPLIFETIME(AGeoGameState, MaxWaves);
+	DOREPLIFETIME_CONDITION(AGeoGameState, WaveDelay, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION(AGeoGameState, MaxWaves, COND_InitialOnly);
 	DOREPLIFETIME(AGeoGameState, CurrentWave);
+	DOREPLIFETIME(AGeoGameState, ReplicatedEnemies);
+	DOREPLIFETIME(AGeoGameState, EnemyArchetypes);
+}
+
+void AGeoGameState::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (HitchDetector)
+	{
+		HitchDetector->Tick(GetWorld()->GetTimeSeconds(), CurrentWave, bWaveActive);
+	}
+
+	EnemyIndex.Update();
+
+	if (bShareSplitScreenCosts && GetNetMode() != NM_DedicatedServer)
+	{
+		UpdateSplitScreen(DeltaSeconds);
+	}
+
+	if (QualityGovernor && QualityGovernor->Tick(FApp::GetDeltaTime() * 1000.f, FSillyGeoFrameEvents::LiveEnemies + FSillyGeoFrameEvents::LiveProjectiles, FPlatformTime::Seconds()))
+	{
+		ApplyQualityTier();
+	}
+
+	if (HasAuthority())
+	{
+		/** record enemy positions for lag compensation  */
+		const float Time = GetWorld()->GetTimeSeconds();
+		if (EnemyHistory.ShouldSample(Time))
+		{
+			EnemyHistory.BeginSample(Time);
+			for (const FEnemyNetEntry& Entry : ReplicatedEnemies.Items)
+			{
+				if (const AEnemyBase* Enemy = Entry.Enemy.Get())
+				{
+					EnemyHistory.Record(Entry.EnemyId, Enemy->GetActorLocation());
+				}
+			}
+		}
+
+		/** enemy bandwidth stats, once per second  */
+		EnemyNetStatsTime += DeltaSeconds;
+		if (EnemyNetStatsTime >= 1.f)
+		{
+			const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+			const int32 Connections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+			const uint32 Bytes = FEnemyNetEntry::ConsumeBytesWritten();
+			if (Connections > 0 && ReplicatedEnemies.Items.Num() > 0)
+			{
+				SET_FLOAT_STAT(STAT_EnemyBytesPerEnemySecond, Bytes / (EnemyNetStatsTime * Connections * ReplicatedEnemies.Items.Num()));
+			}
+			if (Connections > 0)
+			{
+				SET_FLOAT_STAT(STAT_EnemyBytesPerConnectionSecond, Bytes / (EnemyNetStatsTime * Connections));
+			}
+			EnemyNetStatsTime = 0.f;
+		}
+		SET_DWORD_STAT(STAT_ReplicatedEnemies, ReplicatedEnemies.Items.Num());
+
+		/** bucket enemies for per connection relevancy  */
+		if (bUseInterestManagement)
+		{
+			InterestGrid.Reset();
+			for (const FEnemyNetEntry& Entry : ReplicatedEnemies.Items)
+			{
+				InterestGrid.Add(Entry.EnemyId, Entry.GetLocation());
+			}
+		}
+	}
+	else if (PendingEnemyProxies.Num() > 0)
+	{
+		/** try again to spawn enemies that were received before their archetype,
+		*	the ones still without archetype are added back
+		*/
+		const TMap<int32, FEnemyNetEntry> PendingEntries = MoveTemp(PendingEnemyProxies);
+		PendingEnemyProxies.Reset();
+		for (const TPair<int32, FEnemyNetEntry>& Pending : PendingEntries)
+		{
+			OnEnemyNetChanged(Pending.Value);
+		}
+	}
+
+	/** [client] quiet removals announced for proxies whose entries were never removed, e.g. still pending */
+	if (QuietEnemyRemovals.Num() > 0)
+	{
+		const float MaxQuietRemovalAge = 1.f;
+		const float Time = GetWorld()->GetTimeSeconds();
+		for (auto It = QuietEnemyRemovals.CreateIterator(); It; ++It)
+		{
+			if (Time - It.Value() > MaxQuietRemovalAge)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+#if STATS
+	/** emitters are fire and forget, so count them only while somebody looks at the stats */
+	if (FThreadStats::IsCollectingData())
+	{
+		int32 Emitters = 0;
+		for (TObjectIterator<UParticleSystemComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == GetWorld() && It->IsActive())
+			{
+				Emitters++;
+			}
+		}
+		SET_DWORD_STAT(STAT_LiveEmitters, Emitters);
+	}
+#endif
+}
+
+void AGeoGameState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	/** with interest management enemies go through player controllers  */
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGeoGameState, ReplicatedEnemies, !bUseInterestManagement);
+
+	/** wave counters are compared only for a while after they were changed  */
+	const float Time = GetWorld()->GetTimeSeconds();
+	const bool bEnemiesRemainingActive = Time <= EnemiesRemainingActiveUntil;
+	const bool bWaveStateActive = Time <= WaveStateActiveUntil;
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGeoGameState, EnemiesRemaining, bEnemiesRemainingActive);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGeoGameState, bWaveActive, bWaveStateActive);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGeoGameState, CurrentWave, bWaveStateActive);
+
+	/** every connection skips the same compares, so the sum over connections would only scale with players */
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (NetDriver && NetDriver->ClientConnections.Num() > 0)
+	{
+		const int32 SkippedProperties = (bEnemiesRemainingActive ? 0 : 1) + (bWaveStateActive ? 0 : 2);
+		INC_DWORD_STAT_BY(STAT_SkippedRepCompares, SkippedProperties);
+	}
+}
+
+void AGeoGameState::AddPlayerState(class APlayerState* PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+
+	/** new player has to receive the current counters  */
+	if (HasAuthority())
+	{
+		MarkRepDirty(EnemiesRemainingActiveUntil);
+		MarkRepDirty(WaveStateActiveUntil);
+
+		for (APlayerState* OtherPlayerState : PlayerArray)
+		{
+			if (AGeoPlayerState* GeoPlayerState = Cast<AGeoPlayerState>(OtherPlayerState))
+			{
+				GeoPlayerState->MarkEnemiesKilledDirty();
+			}
+		}
+	}
+}
+
+void AGeoGameState::MarkRepDirty(float& ActiveUntil)
+{
+	const bool bWasActive = GetWorld()->GetTimeSeconds() <= ActiveUntil;
+	ActiveUntil = GetWorld()->GetTimeSeconds() + DirtyReplicationTime;
+
+	/** one forced update per burst of changes, later ones go with regular net updates  */
+	if (!bWasActive)
+	{
+		ForceNetUpdate();
+	}
+}
+
+void AGeoGameState::SetWaveActive(bool NewActive)
+{
+	bWaveActive = NewActive;
+	MarkRepDirty(WaveStateActiveUntil);
+}
+
+void AGeoGameState::AddEnemiesRemaining(int32 Amount)
+{
+	EnemiesRemaining += Amount;
+	MarkRepDirty(EnemiesRemainingActiveUntil);
+}
+
+void AGeoGameState::SetCurrentWave(int32 Wave)
+{
+	CurrentWave = Wave;
+	MarkRepDirty(WaveStateActiveUntil);
+}
+
+void AGeoGameState::RegisterEnemy(class AEnemyBase* Enemy)
+{
+	/** nobody to replicate to  */
+	if (!Enemy || GetNetMode() == NM_Standalone) { return; }
+
+	/** clients would spawn another class, so the enemy is not replicated at all */
+	const int32 ArchetypeIndex = GetArchetypeIndex(Enemy->GetClass());
+	if (ArchetypeIndex == INDEX_NONE) { return; }
+
+	FEnemyNetEntry& Entry = ReplicatedEnemies.Items[ReplicatedEnemies.Items.AddDefaulted()];
+	Entry.EnemyId = NextEnemyId++;
+	Entry.ArchetypeIndex = (uint8)ArchetypeIndex;
+	Entry.Color = Enemy->GetColorType();
+	Entry.Enemy = Enemy;
+	Entry.TargetId = GetEnemyTargetId(Enemy);
+	Entry.SteeringSeed = Enemy->GetSteeringSeed();
+	Entry.bDormant = bSimulateDormantEnemies;
+	Entry.SetState(Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetActorRotation().Yaw, GetWorld()->GetTimeSeconds());
+
+	EnemyEntryIndices.Add(Entry.EnemyId, ReplicatedEnemies.Items.Num() - 1);
+	EnemyHistory.AddEnemy(Entry.EnemyId);
+	Enemy->SetNetId(Entry.EnemyId);
+
+	ReplicatedEnemies.MarkItemDirty(Entry);
+}
+
+void AGeoGameState::UpdateEnemy(class AEnemyBase* Enemy)
+{
+	const int32* EntryIndex = Enemy ? EnemyEntryIndices.Find(Enemy->GetNetId()) : nullptr;
+	if (!EntryIndex) { return; }
+
+	FEnemyNetEntry& Entry = ReplicatedEnemies.Items[*EntryIndex];
+	const float Time = GetWorld()->GetTimeSeconds();
+
+	/** clients steer dormant enemies themselves, only correct them once in a while  */
+	bool bDirty = false;
+	if (Entry.bDormant)
+	{
+		if (DormantCorrectionInterval > 0.f && Time - Entry.LastUpdateTime >= DormantCorrectionInterval)
+		{
+			Entry.SetState(Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetActorRotation().Yaw, Time);
+			bDirty = true;
+		}
+	}
+	else
+	{
+		bDirty = Entry.UpdateState(Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetActorRotation().Yaw, Time);
+	}
+
+	if (bDirty)
+	{
+		ReplicatedEnemies.MarkItemDirty(Entry);
+		INC_DWORD_STAT(STAT_DirtyEnemyEntries);
+	}
+}
+
+void AGeoGameState::UpdateEnemySteering(class AEnemyBase* Enemy)
+{
+	const int32* EntryIndex = Enemy ? EnemyEntryIndices.Find(Enemy->GetNetId()) : nullptr;
+	if (!EntryIndex) { return; }
+
+	FEnemyNetEntry& Entry = ReplicatedEnemies.Items[*EntryIndex];
+	Entry.TargetId = GetEnemyTargetId(Enemy);
+	Entry.SteeringSeed = Enemy->GetSteeringSeed();
+	Entry.bDormant = bSimulateDormantEnemies;
+	Entry.SetState(Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetActorRotation().Yaw, GetWorld()->GetTimeSeconds());
+
+	ReplicatedEnemies.MarkItemDirty(Entry);
+	INC_DWORD_STAT(STAT_DirtyEnemyEntries);
+}
+
+int32 AGeoGameState::GetEnemyTargetId(const class AEnemyBase* Enemy)
+{
+	const APawn* Target = Enemy->GetTarget();
+	return Target && Target->PlayerState ? Target->PlayerState->PlayerId : INDEX_NONE;
+}
+
+APawn* AGeoGameState::FindPlayerPawn(int32 PlayerId) const
+{
+	if (PlayerId == INDEX_NONE) { return nullptr; }
+
+	for (TActorIterator<APawn> It(GetWorld()); It; ++It)
+	{
+		if (It->PlayerState && It->PlayerState->PlayerId == PlayerId)
+		{
+			return *It;
+		}
+	}
+	return nullptr;
+}
+
+void AGeoGameState::UnregisterEnemy(class AEnemyBase* Enemy)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (!Enemy || !EnemyEntryIndices.RemoveAndCopyValue(Enemy->GetNetId(), EntryIndex)) { return; }
+
+	EnemyHistory.RemoveEnemy(Enemy->GetNetId());
+
+	/** order doesn't matter for fast array, so swap the last entry in place of removed one */
+	ReplicatedEnemies.Items.RemoveAtSwap(EntryIndex);
+	if (ReplicatedEnemies.Items.IsValidIndex(EntryIndex))
+	{
+		EnemyEntryIndices.Add(ReplicatedEnemies.Items[EntryIndex].EnemyId, EntryIndex);
+	}
+	ReplicatedEnemies.MarkArrayDirty();
+}
+
+AEnemyBase* AGeoGameState::FindEnemy(int32 EnemyId) const
+{
+	const int32* EntryIndex = EnemyEntryIndices.Find(EnemyId);
+	return EntryIndex ? ReplicatedEnemies.Items[*EntryIndex].Enemy.Get() : nullptr;
+}
+
+bool AGeoGameState::ValidateEnemyHit(int32 EnemyId, float Time, const FVector& HitLocation, float Radius) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ValidateHit);
+
+	/** clients steer dormant enemies themselves, so they drift away from the server until corrected.
+	*	If the correction came after the hit, we don't know the one before it, so take the whole interval
+	*/
+	float DriftRadius = 0.f;
+	const int32* EntryIndex = EnemyEntryIndices.Find(EnemyId);
+	if (EntryIndex && ReplicatedEnemies.Items[*EntryIndex].bDormant)
+	{
+		const float LastCorrectionTime = ReplicatedEnemies.Items[*EntryIndex].LastUpdateTime;
+		float DriftTime = Time >= LastCorrectionTime ? Time - LastCorrectionTime : DormantCorrectionInterval;
+		if (DormantCorrectionInterval > 0.f)
+		{
+			DriftTime = FMath::Min(DriftTime, DormantCorrectionInterval);
+		}
+		DriftRadius = FMath::Min(DriftTime * DormantDriftPerSecond, MaxDormantDrift);
+	}
+
+	const bool bValid = EnemyHistory.ValidateHit(EnemyId, Time, FVector2D(HitLocation.X, HitLocation.Y), Radius + DriftRadius);
+	if (!bValid)
+	{
+		INC_DWORD_STAT(STAT_RejectedHits);
+	}
+	return bValid;
+}
+
+bool AGeoGameState::IsRelevantLocation(const FVector& ViewLocation, const FVector& Location) const
+{
+	return !bUseInterestManagement || FGeoInterestGrid::GetCellDistance(InterestGrid.GetCell(ViewLocation), InterestGrid.GetCell(Location)) <= RelevantCellRadius;
+}
+
+void AGeoGameState::UpdateRelevantEnemies(const FVector& ViewLocation, FEnemyNetArray& RelevantEnemies, TMap<int32, int32>& RelevantIndices, uint32 UpdateCounter) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InterestUpdate);
+
+	const FIntPoint ViewCell = InterestGrid.GetCell(ViewLocation);
+	const float Time = GetWorld()->GetTimeSeconds();
+
+	/** if the steering of dormant enemy started a while ago, the connection can't simulate it from the seed,
+	*	so it is sent as regular extrapolated enemy until the next steering restart
+	*/
+	auto CopyEnemy = [Time](FEnemyNetEntry& Relevant, const FEnemyNetEntry& Master)
+	{
+		const float MaxDormantCopyAge = 0.25f;
+
+		Relevant.CopyState(Master);
+		const AEnemyBase* Enemy = Master.Enemy.Get();
+		if (Master.bDormant && Time - Master.LastUpdateTime > MaxDormantCopyAge && Enemy)
+		{
+			Relevant.bDormant = false;
+			Relevant.SetState(Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetActorRotation().Yaw, Time);
+		}
+	};
+
+	/** drop dead and far enemies, refresh the rest  */
+	bool bRemoved = false;
+	for (int32 Index = RelevantEnemies.Items.Num() - 1; Index >= 0; Index--)
+	{
+		FEnemyNetEntry& Relevant = RelevantEnemies.Items[Index];
+		const int32* MasterIndex = EnemyEntryIndices.Find(Relevant.EnemyId);
+		const FEnemyNetEntry* Master = MasterIndex ? &ReplicatedEnemies.Items[*MasterIndex] : nullptr;
+		const int32 CellDistance = Master ? FGeoInterestGrid::GetCellDistance(ViewCell, InterestGrid.GetCell(Master->GetLocation())) : MAX_int32;
+
+		if (!Master || CellDistance > RelevantCellRadius + 1)
+		{
+			RelevantIndices.Remove(Relevant.EnemyId);
+			RelevantEnemies.Items.RemoveAtSwap(Index);
+			if (RelevantEnemies.Items.IsValidIndex(Index))
+			{
+				RelevantIndices.Add(RelevantEnemies.Items[Index].EnemyId, Index);
+			}
+			bRemoved = true;
+		}
+		else if (UpdateCounter % GetRelevantUpdateInterval(CellDistance) != 0)
+		{
+			continue;
+		}
+		else if (Relevant.SourceKey != Master->ReplicationKey)
+		{
+			CopyEnemy(Relevant, *Master);
+			RelevantEnemies.MarkItemDirty(Relevant);
+		}
+		else if (!Relevant.bDormant && Master->bDormant && Master->Enemy.IsValid())
+		{
+			/** extrapolated copy of dormant enemy  */
+			const AEnemyBase* Enemy = Master->Enemy.Get();
+			if (Relevant.UpdateState(Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetActorRotation().Yaw, Time))
+			{
+				RelevantEnemies.MarkItemDirty(Relevant);
+			}
+		}
+	}
+	if (bRemoved)
+	{
+		RelevantEnemies.MarkArrayDirty();
+	}
+
+	/** add enemies that came close  */
+	InterestGrid.ForEachInRadius(ViewCell, RelevantCellRadius, [&](int32 EnemyId, int32 CellDistance)
+	{
+		const int32* MasterIndex = EnemyEntryIndices.Find(EnemyId);
+		if (MasterIndex && !RelevantIndices.Contains(EnemyId))
+		{
+			FEnemyNetEntry& Relevant = RelevantEnemies.Items[RelevantEnemies.Items.AddDefaulted()];
+			CopyEnemy(Relevant, ReplicatedEnemies.Items[*MasterIndex]);
+			RelevantIndices.Add(EnemyId, RelevantEnemies.Items.Num() - 1);
+			RelevantEnemies.MarkItemDirty(Relevant);
+		}
+	});
+
+	INC_DWORD_STAT_BY(STAT_RelevantEnemies, RelevantEnemies.Items.Num());
+}
+
+int32 AGeoGameState::GetArchetypeIndex(TSubclassOf<class AEnemyBase> EnemyClass)
+{
+	int32 Index = EnemyArchetypes.Find(EnemyClass);
+	if (Index == INDEX_NONE)
+	{
+		/** a slot released with its wave  */
+		Index = EnemyArchetypes.IndexOfByPredicate([](const TSubclassOf<AEnemyBase>& Archetype) { return !Archetype; });
+		if (Index != INDEX_NONE)
+		{
+			EnemyArchetypes[Index] = EnemyClass;
+			return Index;
+		}
+
+		if (EnemyArchetypes.Num() >= FEnemyNetEntry::MaxArchetypes)
+		{
+			if (!RejectedArchetypes.Contains(*EnemyClass))
+			{
+				RejectedArchetypes.Add(*EnemyClass);
+				UE_LOG(LogTemp, Error, TEXT("%s is not replicated, all %d enemy archetypes are taken"), *GetNameSafe(EnemyClass), FEnemyNetEntry::MaxArchetypes);
+			}
+			return INDEX_NONE;
+		}
+		Index = EnemyArchetypes.Add(EnemyClass);
+	}
+	return Index;
+}
+
+void AGeoGameState::ReleaseEnemyArchetype(UClass* EnemyClass)
+{
+	/** entries of the wave are gone already, the wave has ended  */
+	const int32 Index = EnemyClass ? EnemyArchetypes.IndexOfByKey(EnemyClass) : INDEX_NONE;
+	if (Index != INDEX_NONE)
+	{
+		EnemyArchetypes[Index] = nullptr;
+	}
+}
+
+AEnemyBase* AGeoGameState::FindOrSpawnEnemyProxy(const FEnemyNetEntry& Entry)
+{
+	if (TWeakObjectPtr<AEnemyBase>* Proxy = EnemyProxies.Find(Entry.EnemyId))
+	{
+		if (Proxy->IsValid())
+		{
+			return Proxy->Get();
+		}
+	}
+
+	/** archetype is not received yet  */
+	if (!EnemyArchetypes.IsValidIndex(Entry.ArchetypeIndex) || !EnemyArchetypes[Entry.ArchetypeIndex])
+	{
+		PendingEnemyProxies.Add(Entry.EnemyId, Entry);
+		return nullptr;
+	}
+
+	SILLYGEO_LLM_SCOPE(Enemies);
+
+	const FTransform SpawnTransform(FRotator(0.f, Entry.GetYaw(), 0.f), Entry.GetLocation());
+	AEnemyBase* Proxy = GetWorld()->SpawnActorDeferred<AEnemyBase>(EnemyArchetypes[Entry.ArchetypeIndex], SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Proxy)
+	{
+		Proxy->InitNetProxy(Entry.EnemyId);
+		Proxy->FinishSpawning(SpawnTransform);
+		EnemyProxies.Add(Entry.EnemyId, Proxy);
+	}
+	return Proxy;
+}
+
+void AGeoGameState::OnEnemyNetAdded(const FEnemyNetEntry& Entry)
+{
+	EnemyProxyRefs.FindOrAdd(Entry.EnemyId)++;
+	OnEnemyNetChanged(Entry);
+}
+
+void AGeoGameState::OnEnemyNetChanged(const FEnemyNetEntry& Entry)
+{
+	if (AEnemyBase* Proxy = FindOrSpawnEnemyProxy(Entry))
+	{
+		Proxy->ApplyNetState(Entry.GetLocation(), Entry.GetVelocity(), Entry.GetYaw(), Entry.Color);
+		Proxy->ApplyNetSteering(Entry.bDormant, Entry.SteeringSeed, FindPlayerPawn(Entry.TargetId));
+	}
+}
+
+void AGeoGameState::OnEnemyNetRemoved(const FEnemyNetEntry& Entry)
+{
+	/** another local controller still has the enemy  */
+	int32* Refs = EnemyProxyRefs.Find(Entry.EnemyId);
+	if (Refs && --(*Refs) > 0) { return; }
+
+	EnemyProxyRefs.Remove(Entry.EnemyId);
+	PendingEnemyProxies.Remove(Entry.EnemyId);
+
+	TWeakObjectPtr<AEnemyBase> Proxy;
+	if (EnemyProxies.RemoveAndCopyValue(Entry.EnemyId, Proxy) && Proxy.IsValid())
+	{
+		/** the server drops enemies only outside RelevantCellRadius + 1 rings,
+		*	so an enemy removed inside the relevant area of any local player is dead, not just far away
+		*/
+		bool bDied = !bUseInterestManagement;
+		bool bHasLocalPawn = false;
+		const FIntPoint ProxyCell = InterestGrid.GetCell(Proxy->GetActorLocation());
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It && !bDied; ++It)
+		{
+			const APlayerController* PC = It->Get();
+			const APawn* LocalPawn = PC && PC->IsLocalPlayerController() ? PC->GetPawn() : nullptr;
+			if (LocalPawn)
+			{
+				bHasLocalPawn = true;
+				bDied = FGeoInterestGrid::GetCellDistance(InterestGrid.GetCell(LocalPawn->GetActorLocation()), ProxyCell) <= RelevantCellRadius;
+			}
+		}
+		bDied |= !bHasLocalPawn;
+
+		/** blast victims but the first die without own explosion  */
+		const bool bQuiet = QuietEnemyRemovals.Remove(Entry.EnemyId) > 0;
+		Proxy->DestroyNetProxy(bDied && !bQuiet);
+	}
+}
+
+void AGeoGameState::MulticastBlastKills_Implementation(const TArray<int32>& QuietEnemyIds)
+{
+	/** the server destroys enemies itself  */
+	if (HasAuthority()) { return; }
+
+	const float Time = GetWorld()->GetTimeSeconds();
+	for (int32 EnemyId : QuietEnemyIds)
+	{
+		/** already removed, its explosion is played  */
+		if (!EnemyProxies.Contains(EnemyId) && !PendingEnemyProxies.Contains(EnemyId))
+		{
+			continue;
+		}
+		QuietEnemyRemovals.Add(EnemyId, Time);
+	}
+}
+
+bool AGeoGameState::ConsumeExplosionFX(const FVector& Location)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (QualityGovernor && !QualityGovernor->ConsumeExplosion(Now))
+	{
+		return false;
+	}
+	if (!bSplitScreenActive || MaxExplosionsPerView <= 0)
+	{
+		return true;
+	}
+
+	/** the explosion is charged to the view it is closest to  */
+	int32 NearestView = 0;
+	float NearestDistSq = MAX_FLT;
+	for (int32 i = 0; i < LocalViews.Num(); i++)
+	{
+		const float DistSq = FVector::DistSquared(LocalViews[i], Location);
+		if (DistSq < NearestDistSq)
+		{
+			NearestDistSq = DistSq;
+			NearestView = i;
+		}
+	}
+	return !ViewExplosionBudgets.IsValidIndex(NearestView) || ViewExplosionBudgets[NearestView].Consume(MaxExplosionsPerView, Now);
+}
+
+void AGeoGameState::UpdateSplitScreen(float DeltaSeconds)
+{
+	LocalViews.Reset();
+	LocalGeos.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalPlayerController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			LocalViews.Add(ViewLocation);
+			LocalGeos.Add(Cast<AGeo>(PC->GetPawn()));
+		}
+	}
+	ViewExplosionBudgets.SetNum(LocalViews.Num());
+
+	const bool bWasSplitScreen = bSplitScreenActive;
+	bSplitScreenActive = LocalViews.Num() > 1;
+
+	if (!bSplitScreenActive)
+	{
+		/** back to one view, everybody gets own sparks and every enemy is significant */
+		if (bWasSplitScreen)
+		{
+			for (TActorIterator<AGeo> It(GetWorld()); It; ++It)
+			{
+				It->StopSharingWorldSparks();
+			}
+			for (TActorIterator<AEnemyBase> It(GetWorld()); It; ++It)
+			{
+				It->SetViewSignificance(true);
+			}
+		}
+		return;
+	}
+
+	GroupLocalViews();
+	ShareSparksByViewGroup();
+
+	SignificanceTime += DeltaSeconds;
+	if (SignificanceTime >= SignificanceInterval || !bWasSplitScreen)
+	{
+		SignificanceTime = 0.f;
+		UpdateEnemySignificance();
+	}
+}
+
+void AGeoGameState::GroupLocalViews()
+{
+	ViewGroups.Reset();
+	LocalViewGroups.Reset();
+
+	const float MergeDistSq = FMath::Square(ViewMergeDistance);
+	for (const FVector& View : LocalViews)
+	{
+		int32 Group = ViewGroups.IndexOfByPredicate([&View, MergeDistSq](const FVector& GroupLocation) { return FVector::DistSquared(GroupLocation, View) < MergeDistSq; });
+		if (Group == INDEX_NONE)
+		{
+			Group = ViewGroups.Add(View);
+		}
+		LocalViewGroups.Add(Group);
+	}
+	SET_DWORD_STAT(STAT_SplitScreenViewGroups, ViewGroups.Num());
+}
+
+void AGeoGameState::ShareSparksByViewGroup()
+{
+	for (int32 Group = 0; Group < ViewGroups.Num(); Group++)
+	{
+		/** the first Geo of the group owns the sparks, they hang under the center of the group Geos */
+		FVector Center = FVector::ZeroVector;
+		int32 NumGeos = 0;
+		AGeo* SparksOwner = nullptr;
+		for (int32 View = 0; View < LocalGeos.Num(); View++)
+		{
+			if (LocalViewGroups[View] == Group && LocalGeos[View].IsValid())
+			{
+				Center += LocalGeos[View]->GetActorLocation();
+				NumGeos++;
+				SparksOwner = SparksOwner ? SparksOwner : LocalGeos[View].Get();
+			}
+		}
+		if (NumGeos == 0) { continue; }
+
+		Center /= NumGeos;
+		for (int32 View = 0; View < LocalGeos.Num(); View++)
+		{
+			AGeo* Geo = LocalViewGroups[View] == Group ? LocalGeos[View].Get() : nullptr;
+			if (!Geo) { continue; }
+
+			/** a view of its own is covered by own sparks  */
+			if (NumGeos == 1)
+			{
+				Geo->StopSharingWorldSparks();
+			}
+			else
+			{
+				Geo->ShareWorldSparks(Geo == SparksOwner, Center);
+			}
+		}
+	}
+}
+
+void AGeoGameState::UpdateEnemySignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SplitScreenSignificance);
+
+	/** views that overlap are evaluated once  */
+	const float SignificantDistSq = FMath::Square(SignificanceDistance);
+	int32 LowSignificance = 0;
+	for (TActorIterator<AEnemyBase> It(GetWorld()); It; ++It)
+	{
+		const FVector Location = It->GetActorLocation();
+		const bool bSignificant = ViewGroups.ContainsByPredicate([&Location, SignificantDistSq](const FVector& Group) { return FVector::DistSquared(Group, Location) < SignificantDistSq; });
+		It->SetViewSignificance(bSignificant);
+		LowSignificance += bSignificant ? 0 : 1;
+	}
+	SET_DWORD_STAT(STAT_SplitScreenLowSignificance, LowSignificance);
+}
+
+void AGeoGameState::ApplyQualityTier()
+{
+	const FGeoQualitySettings* Settings = GetQualitySettings();
+	if (!Settings) { return; }
+
+	/** new actors apply the tier in BeginPlay  */
+	for (TActorIterator<AGeo> It(GetWorld()); It; ++It)
+	{
+		It->ApplyQualitySettings(*Settings);
+	}
+	for (TActorIterator<AEnemyBase> It(GetWorld()); It; ++It)
+	{
+		It->ApplyQualitySettings(*Settings);
+	}
+	for (TActorIterator<AProjectile> It(GetWorld()); It; ++It)
+	{
+		It->ApplyQualitySettings(*Settings);
+	}
 }
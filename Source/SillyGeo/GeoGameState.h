@@ -4,6 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+#include "Engine/StreamableManager.h"
+#include "EnemyNetState.h"
+#include "EnemyPositionHistory.h"
+#include "GeoInterestGrid.h"
+#include "GeoHitchDetector.h"
+#include "GeoQualityGovernor.h"
+#include "GeoEnemySpatialIndex.h"
 #include "GeoGameState.generated.h"
 
 /**
@@ -15,26 +22,73 @@ class SILLYGEO_API AGeoGameState : public AGameState
 	GENERATED_BODY()
 	
 public:
+
+	AGeoGameState();
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	virtual void AddPlayerState(class APlayerState* PlayerState) override;
+
+	/** [client] the game mode class is known, starts the asset preload  */
+	virtual void ReceivedGameModeClass() override;
 	
 	/** calls to activate/deactivate current wave  */
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
-	void SetWaveActive(bool NewActive) { bWaveActive = NewActive; }
+	void SetWaveActive(bool NewActive);
 
 	/** calls to add the specified amount of enemies to remaining enemies counter */
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
-	void AddEnemiesRemaining(int32 Amount) { EnemiesRemaining += Amount; }
+	void AddEnemiesRemaining(int32 Amount);
 
-	/** sets the delay between waves  */
+	/** sets the delay between waves, replicated only with the initial bunch  */
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
 	void SetWaveDelay(float Delay) { WaveDelay = Delay; }
 
-	/** sets the max waves amount  */
+	/** sets the max waves amount, replicated only with the initial bunch  */
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
 	void SetMaxWaves(int32 Waves) { MaxWaves = Waves; }
 
 	/** sets the current wave number  */
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
-	void SetCurrentWave(int32 Wave) { CurrentWave = Wave; }
+	void SetCurrentWave(int32 Wave);
+
+	// -------------- Q U A L I T Y ----------------------------------------------
+
+	/** returns the settings of the current quality tier, nullptr if quality isn't governed (dedicated server) */
+	const FGeoQualitySettings* GetQualitySettings() const { return QualityGovernor ? &QualityGovernor->GetSettings() : nullptr; }
+
+	/** returns the current quality tier, 0 is the best one, INDEX_NONE if quality isn't governed (dedicated server) */
+	int32 GetQualityTier() const { return QualityGovernor ? QualityGovernor->GetTier() : INDEX_NONE; }
+
+	/** returns all quality tiers, the best one first  */
+	const TArray<FGeoQualitySettings>& GetQualityTiers() const { return QualityTiers; }
+
+	/** returns true if one more explosion emitter at Location fits into the budget of the current tier
+	*	and, in split-screen, of the nearest local view
+	*/
+	bool ConsumeExplosionFX(const FVector& Location);
+
+	/** returns true if more than one local player shares the screen  */
+	bool IsSplitScreen() const { return bSplitScreenActive; }
+
+	// -------------- E N E M Y   I N D E X --------------------------------------
+
+	/** adds the enemy to the spatial index, returns the handle to remove it with */
+	int32 AddIndexedEnemy(class AEnemyBase* Enemy) { return EnemyIndex.Add(Enemy); }
+
+	/** removes the enemy with specified handle from the spatial index  */
+	void RemoveIndexedEnemy(int32& Handle) { EnemyIndex.Remove(Handle); }
+
+	/** returns live enemies bucketed by cells of the arena plane, for nearest / radius queries */
+	const FGeoEnemySpatialIndex& GetEnemyIndex() const { return EnemyIndex; }
 	
 	// -------------- H U D ------------------------------------------------------
 
@@ -53,9 +107,309 @@ public:
 	/** returns max waves / current wave  */
 	UFUNCTION(BlueprintCallable, Category = "HUD")
 	void GetWaves(int32& Max, int32& Current) const { Max = MaxWaves; Current = CurrentWave; }
+
+	// -------------- E N E M I E S   R E P L I C A T I O N ----------------------
+
+	/** [server] calls when enemy is spawned to start replicating its state  */
+	void RegisterEnemy(class AEnemyBase* Enemy);
+
+	/** [server] calls every enemy tick to update its replicated state  */
+	void UpdateEnemy(class AEnemyBase* Enemy);
+
+	/** [server] calls when enemy restarts its steering (new seed or target) */
+	void UpdateEnemySteering(class AEnemyBase* Enemy);
+
+	/** [server] calls when enemy leaves the game to stop replicating it */
+	void UnregisterEnemy(class AEnemyBase* Enemy);
+
+	/** [server] frees the archetype slot of enemy class whose wave is released, so neither
+	*	the server nor clients keep the class loaded, the slot is reused by later classes
+	*/
+	void ReleaseEnemyArchetype(UClass* EnemyClass);
+
+	/** [server] returns replicated enemy with specified id  */
+	class AEnemyBase* FindEnemy(int32 EnemyId) const;
+
+	/** [server] rewinds the enemy to specified server time and checks whether it was
+	*	within Radius from the hit location
+	*/
+	bool ValidateEnemyHit(int32 EnemyId, float Time, const FVector& HitLocation, float Radius) const;
+
+	// -------------- I N T E R E S T   M A N A G E M E N T ----------------------
+
+	/** returns true if every connection gets only enemies and shots near its view  */
+	FORCEINLINE bool UsesInterestManagement() const { return bUseInterestManagement; }
+
+	/** [server] returns true if something at Location is relevant to the viewer at ViewLocation */
+	bool IsRelevantLocation(const FVector& ViewLocation, const FVector& Location) const;
+
+	/** [server] brings per connection enemy array up to date with enemies near ViewLocation,
+	*	far cells are refreshed less often
+	*	@param UpdateCounter - the number of the connection net update, used to skip far cells
+	*/
+	void UpdateRelevantEnemies(const FVector& ViewLocation, FEnemyNetArray& RelevantEnemies, TMap<int32, int32>& RelevantIndices, uint32 UpdateCounter) const;
+
+	/** [client] calls when new enemy entry is received  */
+	void OnEnemyNetAdded(const FEnemyNetEntry& Entry);
+
+	/** [client] calls when enemy entry is changed  */
+	void OnEnemyNetChanged(const FEnemyNetEntry& Entry);
+
+	/** [client] calls when enemy entry is removed from one of replicated arrays,
+	*	the proxy is destroyed once no array holds the entry
+	*/
+	void OnEnemyNetRemoved(const FEnemyNetEntry& Entry);
+
+	/** [server] calls before enemies killed by one blast die, clients remove proxies of QuietEnemyIds
+	*	without explosions, the blast is shown by the one explosion of the first victim
+	*/
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastBlastKills(const TArray<int32>& QuietEnemyIds);
 	
 private:
 
+	/** [client] spawns a local enemy to represent replicated entry if we haven't it yet  */
+	class AEnemyBase* FindOrSpawnEnemyProxy(const FEnemyNetEntry& Entry);
+
+	/** [client] returns the pawn of the player with specified PlayerId  */
+	class APawn* FindPlayerPawn(int32 PlayerId) const;
+
+	/** [server] returns PlayerId of the player whose pawn the enemy is chasing  */
+	static int32 GetEnemyTargetId(const class AEnemyBase* Enemy);
+
+	/** [server] returns the index of enemy template in EnemyArchetypes, adds the template if needed,
+	*	INDEX_NONE if all FEnemyNetEntry::MaxArchetypes slots are taken
+	*/
+	int32 GetArchetypeIndex(TSubclassOf<class AEnemyBase> EnemyClass);
+
+	/** [server] returns how often (in net updates) enemies at specified cell distance are refreshed */
+	int32 GetRelevantUpdateInterval(int32 CellDistance) const { return 1 + FMath::Max(CellDistance - NearCellRadius, 0); }
+
+	/** all replicated enemies, sent to everybody only without interest management,
+	*	otherwise it is the master copy for per connection arrays of player controllers
+	*/
+	UPROPERTY(Replicated)
+	FEnemyNetArray ReplicatedEnemies;
+
+	/** enemy classes referenced by replicated enemies entries, released slots are null  */
+	UPROPERTY(Replicated)
+	TArray<TSubclassOf<class AEnemyBase>> EnemyArchetypes;
+
+	/** [server] enemy classes that found no free archetype slot, logged once  */
+	TArray<TWeakObjectPtr<UClass>> RejectedArchetypes;
+
+	/** [server] enemy id -> index in ReplicatedEnemies  */
+	TMap<int32, int32> EnemyEntryIndices;
+
+	/** [server] the id for next registered enemy  */
+	int32 NextEnemyId = 0;
+
+	/** [client] enemy id -> local enemy actor that represents it  */
+	TMap<int32, TWeakObjectPtr<class AEnemyBase>> EnemyProxies;
+
+	/** [client] enemy id -> how many replicated arrays hold its entry, in split-screen every local
+	*	controller has own RelevantEnemies, the proxy goes when the last of them drops the entry
+	*/
+	TMap<int32, int32> EnemyProxyRefs;
+
+	/** [client] enemy id -> the latest entry received before its archetype, kept here because
+	*	with interest management entries come through player controllers, not ReplicatedEnemies
+	*/
+	TMap<int32, FEnemyNetEntry> PendingEnemyProxies;
+
+	/** [client] enemy id -> time its quiet removal was announced. With interest management the removal
+	*	comes on another channel and may beat the announcement, then the proxy just explodes
+	*/
+	TMap<int32, float> QuietEnemyRemovals;
+
+	/** [server] time accumulated for enemy bandwidth stats  */
+	float EnemyNetStatsTime = 0.f;
+
+	/** how far back (in sec) the server can rewind enemies to validate client hits */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float LagCompensationWindow = 0.25f;
+
+	/** how many times a second enemy positions are recorded for lag compensation */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float LagCompensationSampleRate = 60.f;
+
+	/** [server] recent enemy positions  */
+	FEnemyPositionHistory EnemyHistory;
+
+	/** if true, clients simulate enemy steering from the replicated seed and target,
+	*	the server sends enemies again only when they change the target or to correct the location
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	bool bSimulateDormantEnemies = true;
+
+	/** how often (in sec) the location of dormant enemy is corrected, 0 - never */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float DormantCorrectionInterval = 3.f;
+
+	/** how fast (in uu/sec) a dormant enemy steered by a client drifts from the server one,
+	*	hits on dormant enemies are validated with the drift since the last correction added
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float DormantDriftPerSecond = 60.f;
+
+	/** the max drift (in uu) added to the hit radius of dormant enemies  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float MaxDormantDrift = 200.f;
+
+	/** if true, every connection is sent only enemies and shots from the cells near its Geo  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	bool bUseInterestManagement = true;
+
+	/** the size (in uu) of interest grid cell  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float InterestCellSize = 1024.f;
+
+	/** how many rings of cells around the viewer are relevant, one more ring is kept before the enemy is dropped */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	int32 RelevantCellRadius = 3;
+
+	/** rings of cells refreshed every net update, every next ring is refreshed one update less often */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	int32 NearCellRadius = 1;
+
+	/** [server] replicated enemy ids bucketed by cells, rebuilt every tick  */
+	FGeoInterestGrid InterestGrid;
+
+	/** how long (in sec) a changed wave counter stays active for replication, so every connection gets it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float DirtyReplicationTime = 1.f;
+
+	/** [server] the time EnemiesRemaining stops to be compared for replication  */
+	float EnemiesRemainingActiveUntil = 0.f;
+
+	/** [server] the time bWaveActive and CurrentWave stop to be compared for replication  */
+	float WaveStateActiveUntil = 0.f;
+
+	/** [server] calls when replicated counter is changed  */
+	void MarkRepDirty(float& ActiveUntil);
+
+	// -------------- H I T C H E S ----------------------------------------------
+
+	/** if true, slow frames are captured with the frames before them into Saved/Profiling/Hitches, -GeoHitchMs=N overrides the threshold */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Profiling", meta = (AllowPrivateAccess = "true"))
+	bool bDetectHitches = true;
+
+	/** frames longer than this (in ms) are hitches  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Profiling", meta = (AllowPrivateAccess = "true"))
+	float HitchThresholdMs = 50.f;
+
+	/** how many frames before the hitch (including it) are captured  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Profiling", meta = (AllowPrivateAccess = "true"))
+	int32 HitchFramesToCapture = 120;
+
+	/** min time (in sec) between two captures  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Profiling", meta = (AllowPrivateAccess = "true"))
+	float MinHitchCaptureInterval = 10.f;
+
+	/** max captures per session, 0 - unlimited  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Profiling", meta = (AllowPrivateAccess = "true"))
+	int32 MaxHitchCaptures = 20;
+
+	TUniquePtr<FGeoHitchDetector> HitchDetector;
+
+	// -------------- Q U A L I T Y ----------------------------------------------
+
+	/** if true, cosmetic costs are scaled back through QualityTiers when frame time or entity counts grow */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	bool bGovernQuality = true;
+
+	/** frame time (in ms) the governor keeps the rolling average under  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	float QualityTargetFrameMs = 16.7f;
+
+	/** quality tiers, the best one first  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	TArray<FGeoQualitySettings> QualityTiers;
+
+	TUniquePtr<FGeoQualityGovernor> QualityGovernor;
+
+	/** applies the current tier to Geos, enemies and projectiles alive  */
+	void ApplyQualityTier();
+
+	// -------------- P R E L O A D ----------------------------------------------
+
+	/** [client] starts async streaming of the assets the game mode preloads on the server,
+	*	once the game mode class is replicated, so OnConstruction of proxies finds them loaded
+	*/
+	void PreloadClientAssets();
+
+	/** [client] calls when all preloaded assets are streamed in  */
+	void OnClientAssetsPreloaded();
+
+	FStreamableManager StreamableManager;
+
+	/** [client] keeps preloaded assets in memory  */
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** [client] wall time the preload started (in sec)  */
+	double PreloadStartTime = 0.0;
+
+	// -------------- S P L I T   S C R E E N ------------------------------------
+
+	/** if true, local players of split-screen share one enemy significance pass, and players whose views
+	*	overlap share one world sparks emitter
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	bool bShareSplitScreenCosts = true;
+
+	/** views closer than this (in uu) overlap and are evaluated as one  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	float ViewMergeDistance = 1500.f;
+
+	/** enemies farther than this (in uu) from every local view are low significance */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	float SignificanceDistance = 5000.f;
+
+	/** how often (in sec) enemy significance is evaluated  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	float SignificanceInterval = 0.1f;
+
+	/** explosion emitters a second every local view may spawn in split-screen, 0 - unlimited */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Quality", meta = (AllowPrivateAccess = "true"))
+	int32 MaxExplosionsPerView = 15;
+
+	/** view locations of local players and their Geos, gathered every tick */
+	TArray<FVector> LocalViews;
+	TArray<TWeakObjectPtr<class AGeo>> LocalGeos;
+
+	/** locations of view groups (the first view of the group) and the group of every local view,
+	*	views closer than ViewMergeDistance to the group location join it, regrouped every tick
+	*/
+	TArray<FVector, TInlineAllocator<4>> ViewGroups;
+	TArray<int32, TInlineAllocator<4>> LocalViewGroups;
+
+	/** explosion budget of every local view  */
+	TArray<FGeoExplosionBudget> ViewExplosionBudgets;
+
+	bool bSplitScreenActive = false;
+	float SignificanceTime = 0.f;
+
+	/** [tick] gathers local views, shares sparks and evaluates enemy significance in split-screen */
+	void UpdateSplitScreen(float DeltaSeconds);
+
+	/** puts overlapping local views into ViewGroups  */
+	void GroupLocalViews();
+
+	/** gives every view group of several Geos one sparks emitter, Geos alone in their group keep own sparks */
+	void ShareSparksByViewGroup();
+
+	/** one significance pass over all enemies for all view groups  */
+	void UpdateEnemySignificance();
+
+	// -------------- E N E M Y   I N D E X --------------------------------------
+
+	/** the size (in uu) of enemy index cell, about the distance of a typical query */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay", meta = (AllowPrivateAccess = "true"))
+	float EnemyIndexCellSize = 512.f;
+
+	/** live enemies (not warm-up copies) on every machine, updated every tick */
+	FGeoEnemySpatialIndex EnemyIndex;
+
 	/** shows how many enemies we need to kill  */
 	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	int32 EnemiesRemaining;
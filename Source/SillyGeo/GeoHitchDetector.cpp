@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoHitchDetector.h"
+#include "Async/Async.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/DateTime.h"
+#include "HAL/PlatformTime.h"
+#include "RenderCore.h"
+#include "UObject/UObjectGlobals.h"
+
+FGeoHitchDetector::~FGeoHitchDetector()
+{
+	Stop();
+}
+
+void FGeoHitchDetector::Start(int32 FramesToKeep)
+{
+	Stop();
+
+	Frames.SetNumZeroed(FMath::Max(FramesToKeep, 1));
+	Head = 0;
+	NumFrames = 0;
+	LastTickTime = 0.0;
+	PendingGCMs = 0.0;
+
+	PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FGeoHitchDetector::OnPreGarbageCollect);
+	PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FGeoHitchDetector::OnPostGarbageCollect);
+}
+
+void FGeoHitchDetector::Stop()
+{
+	if (PreGCHandle.IsValid())
+	{
+		FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+		FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+		PreGCHandle.Reset();
+		PostGCHandle.Reset();
+	}
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+}
+
+void FGeoHitchDetector::Tick(float WorldTime, int32 Wave, bool bWaveActive)
+{
+	if (Frames.Num() == 0) { return; }
+
+	/** the engine delta is the wall time of the last frame, unless the time step is fixed */
+	const double Now = FPlatformTime::Seconds();
+	const float FrameTime = FApp::UseFixedTimeStep() ? (float)((Now - LastTickTime) * 1000.0) : (float)(FApp::GetDeltaTime() * 1000.0);
+	const bool bFirstTick = LastTickTime == 0.0;
+	LastTickTime = Now;
+
+	FGeoHitchFrame& Frame = Frames[Head];
+	Frame.Frame = GFrameCounter;
+	Frame.Time = WorldTime;
+	Frame.FrameTime = FrameTime;
+	Frame.GameThreadTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Frame.RenderThreadTime = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	Frame.GCTime = (float)PendingGCMs;
+	Frame.Wave = Wave;
+	Frame.bWaveActive = bWaveActive;
+	Frame.LiveEnemies = FSillyGeoFrameEvents::LiveEnemies;
+	Frame.LiveProjectiles = FSillyGeoFrameEvents::LiveProjectiles;
+	FMemory::Memcpy(Frame.Events, FSillyGeoFrameEvents::LastFrame, sizeof(Frame.Events));
+#if SILLYGEO_FRAME_COUNTERS
+	FMemory::Memcpy(Frame.CounterMs, FSillyGeoFrameCounters::LastFrameMs, sizeof(Frame.CounterMs));
+#endif
+	PendingGCMs = 0.0;
+
+	Head = (Head + 1) % Frames.Num();
+	NumFrames = FMath::Min(NumFrames + 1, Frames.Num());
+
+	/** the first frame carries the map load  */
+	if (bFirstTick || FrameTime < ThresholdMs) { return; }
+
+	if (MaxCaptures > 0 && NumCaptures >= MaxCaptures) { return; }
+	if (LastCaptureTime > 0.0 && Now - LastCaptureTime < MinCaptureInterval) { return; }
+
+	/** still writing the previous one  */
+	if (PendingWrite.IsValid() && !PendingWrite.IsReady()) { return; }
+
+	LastCaptureTime = Now;
+	NumCaptures++;
+	Capture(Frames[(Head + Frames.Num() - 1) % Frames.Num()]);
+}
+
+void FGeoHitchDetector::Capture(const FGeoHitchFrame& Hitch)
+{
+	TArray<FGeoHitchFrame> Captured;
+	Captured.Reserve(NumFrames);
+	for (int32 i = NumFrames; i > 0; i--)
+	{
+		Captured.Add(Frames[(Head + Frames.Num() - i) % Frames.Num()]);
+	}
+
+	const FString Path = FPaths::Combine(FPaths::ProfilingDir(), TEXT("Hitches"),
+		FString::Printf(TEXT("Hitch-%s-%llu.csv"), *FDateTime::Now().ToString(), Hitch.Frame));
+
+	UE_LOG(LogTemp, Warning, TEXT("Hitch %.1f ms (GT %.1f ms, RT %.1f ms, GC %.1f ms) at wave %d, %d enemies, %d projectiles, captured to %s"),
+		Hitch.FrameTime, Hitch.GameThreadTime, Hitch.RenderThreadTime, Hitch.GCTime,
+		Hitch.Wave, Hitch.LiveEnemies, Hitch.LiveProjectiles, *Path);
+
+	PendingWrite = Async<void>(EAsyncExecution::ThreadPool, [Path, Captured = MoveTemp(Captured)]()
+	{
+		if (!FFileHelper::SaveStringToFile(ToCsv(Captured), *Path))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to write hitch capture %s"), *Path);
+		}
+	});
+}
+
+FString FGeoHitchDetector::ToCsv(const TArray<FGeoHitchFrame>& Frames)
+{
+	FString Csv = TEXT("Frame,Time,FrameMs,GameThreadMs,RenderThreadMs,GCMs,Wave,WaveActive,Enemies,Projectiles");
+	for (int32 i = 0; i < FSillyGeoFrameEvents::Num; i++)
+	{
+		Csv += FString::Printf(TEXT(",%s"), FSillyGeoFrameEvents::Names[i]);
+	}
+#if SILLYGEO_FRAME_COUNTERS
+	for (int32 i = 0; i < FSillyGeoFrameCounters::Num; i++)
+	{
+		Csv += FString::Printf(TEXT(",%sMs"), FSillyGeoFrameCounters::Names[i]);
+	}
+#endif
+	Csv += LINE_TERMINATOR;
+
+	for (const FGeoHitchFrame& Frame : Frames)
+	{
+		Csv += FString::Printf(TEXT("%llu,%.3f,%.2f,%.2f,%.2f,%.2f,%d,%d,%d,%d"),
+			Frame.Frame, Frame.Time, Frame.FrameTime, Frame.GameThreadTime, Frame.RenderThreadTime, Frame.GCTime,
+			Frame.Wave, Frame.bWaveActive ? 1 : 0, Frame.LiveEnemies, Frame.LiveProjectiles);
+		for (int32 i = 0; i < FSillyGeoFrameEvents::Num; i++)
+		{
+			Csv += FString::Printf(TEXT(",%d"), Frame.Events[i]);
+		}
+#if SILLYGEO_FRAME_COUNTERS
+		for (int32 i = 0; i < FSillyGeoFrameCounters::Num; i++)
+		{
+			Csv += FString::Printf(TEXT(",%.3f"), Frame.CounterMs[i]);
+		}
+#endif
+		Csv += LINE_TERMINATOR;
+	}
+	return Csv;
+}
+
+void FGeoHitchDetector::OnPreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void FGeoHitchDetector::OnPostGarbageCollect()
+{
+	PendingGCMs += (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+}
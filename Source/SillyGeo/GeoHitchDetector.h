@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "SillyGeoStats.h"
+
+/** everything we know about one frame  */
+struct FGeoHitchFrame
+{
+	uint64 Frame = 0;
+
+	/** world time in seconds  */
+	float Time = 0.f;
+
+	/** ms  */
+	float FrameTime = 0.f;
+	float GameThreadTime = 0.f;
+	float RenderThreadTime = 0.f;
+
+	/** ms spent in garbage collection passes during the frame  */
+	float GCTime = 0.f;
+
+	int32 Wave = 0;
+	bool bWaveActive = false;
+
+	int32 LiveEnemies = 0;
+	int32 LiveProjectiles = 0;
+
+	/** gameplay events of the frame  */
+	int32 Events[FSillyGeoFrameEvents::Num];
+
+#if SILLYGEO_FRAME_COUNTERS
+	/** ms spent in gameplay scopes  */
+	float CounterMs[FSillyGeoFrameCounters::Num];
+#endif
+};
+
+/**
+*	keeps the last frames in a ring buffer and, when a frame takes longer than the threshold,
+*	writes them with the gameplay state into Saved/Profiling/Hitches/Hitch-<time>-<frame>.csv.
+*	Captures are rate limited and written on the thread pool, so a hitch doesn't cause the next one
+*/
+class SILLYGEO_API FGeoHitchDetector
+{
+public:
+
+	~FGeoHitchDetector();
+
+	/** allocates the ring buffer and starts timing GC passes  */
+	void Start(int32 FramesToKeep);
+
+	/** waits for the pending capture and stops timing GC passes */
+	void Stop();
+
+	/** [game thread] records the last finished frame, calls once per frame  */
+	void Tick(float WorldTime, int32 Wave, bool bWaveActive);
+
+	/** frames slower than this (in ms) are captured  */
+	float ThresholdMs = 50.f;
+
+	/** min time (in sec) between two captures  */
+	float MinCaptureInterval = 10.f;
+
+	/** max captures per session, 0 - unlimited  */
+	int32 MaxCaptures = 20;
+
+private:
+
+	/** writes the ring buffer, oldest frame first  */
+	void Capture(const FGeoHitchFrame& Hitch);
+
+	static FString ToCsv(const TArray<FGeoHitchFrame>& Frames);
+
+	/** GC delegates  */
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	TArray<FGeoHitchFrame> Frames;
+
+	/** the slot for the next frame  */
+	int32 Head = 0;
+
+	/** frames recorded since start, up to Frames.Num()  */
+	int32 NumFrames = 0;
+
+	double LastTickTime = 0.0;
+	double LastCaptureTime = 0.0;
+	int32 NumCaptures = 0;
+
+	/** GC time not yet attributed to a frame  */
+	double PendingGCMs = 0.0;
+	double GCStartTime = 0.0;
+
+	FDelegateHandle PreGCHandle;
+	FDelegateHandle PostGCHandle;
+
+	TFuture<void> PendingWrite;
+};
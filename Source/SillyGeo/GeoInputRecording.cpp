@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoInputRecording.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+bool FGeoInputHeader::Read(const FString& Path, FGeoInputHeader& OutHeader)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	*Reader << OutHeader;
+	return !Reader->IsError() && OutHeader.Magic == FileMagic && OutHeader.Version == FileVersion;
+}
+
+FString FGeoInputHeader::GetFullPath(const FString& Path)
+{
+	return FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectSavedDir(), Path) : Path;
+}
+
+// -------------- R E C O R D E R --------------------------------------------
+
+FGeoInputRecorder::~FGeoInputRecorder()
+{
+	Stop();
+}
+
+bool FGeoInputRecorder::Start(const FString& Path, const FGeoInputHeader& Header)
+{
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!FileWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't create input recording %s"), *Path);
+		return false;
+	}
+
+	Chunk.Reserve(ChunkSize + 64);
+	FMemoryWriter Writer(Chunk, false, true);
+	FGeoInputHeader HeaderToWrite = Header;
+	Writer << HeaderToWrite;
+
+	LastFrame = FGeoInputFrame();
+	FrameIndex = 0;
+	LastRecordFrame = 0;
+
+	UE_LOG(LogTemp, Log, TEXT("Recording input to %s"), *Path);
+	return true;
+}
+
+void FGeoInputRecorder::Record(const FGeoInputFrame& Frame)
+{
+	if (!FileWriter) { return; }
+
+	/** the very first frame is always written  */
+	if (FrameIndex == 0 || Frame != LastFrame)
+	{
+		WriteRecord(Frame);
+		LastFrame = Frame;
+	}
+	FrameIndex++;
+
+	if (Chunk.Num() >= ChunkSize)
+	{
+		FlushChunk();
+	}
+}
+
+void FGeoInputRecorder::WriteRecord(const FGeoInputFrame& Frame)
+{
+	FMemoryWriter Writer(Chunk, false, true);
+
+	uint32 FrameDelta = (uint32)(FrameIndex - LastRecordFrame);
+	Writer.SerializeIntPacked(FrameDelta);
+	FGeoInputFrame FrameToWrite = Frame;
+	Writer << FrameToWrite;
+
+	LastRecordFrame = FrameIndex;
+}
+
+void FGeoInputRecorder::FlushChunk()
+{
+	if (Chunk.Num() == 0) { return; }
+
+	/** chunks are written in order, the previous one is long done by now */
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
+	FArchive* File = FileWriter.Get();
+	PendingWrite = Async<void>(EAsyncExecution::ThreadPool, [File, Data = MoveTemp(Chunk)]() mutable
+	{
+		File->Serialize(Data.GetData(), Data.Num());
+	});
+	Chunk.Reset(ChunkSize + 64);
+}
+
+void FGeoInputRecorder::Stop()
+{
+	if (!FileWriter) { return; }
+
+	FGeoInputFrame EndFrame = LastFrame;
+	EndFrame.Buttons |= FGeoInputFrame::EndOfRecording;
+	WriteRecord(EndFrame);
+	FlushChunk();
+
+	PendingWrite.Wait();
+	FileWriter->Close();
+	FileWriter.Reset();
+
+	UE_LOG(LogTemp, Log, TEXT("Input recording finished: %d frames"), FrameIndex);
+}
+
+// -------------- P L A Y E R ------------------------------------------------
+
+bool FGeoInputPlayer::Load(const FString& Path)
+{
+	if (!FFileHelper::LoadFileToArray(Data, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't load input recording %s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	Reader << Header;
+	if (Reader.IsError() || Header.Magic != FGeoInputHeader::FileMagic || Header.Version != FGeoInputHeader::FileVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not an input recording"), *Path);
+		return false;
+	}
+
+	Offset = Reader.Tell();
+	CurrentFrame = FGeoInputFrame();
+	bFinished = false;
+	bHasPending = ReadRecord();
+	return bHasPending;
+}
+
+bool FGeoInputPlayer::ReadRecord()
+{
+	if (Offset >= Data.Num()) { return false; }
+
+	FMemoryReader Reader(Data);
+	Reader.Seek(Offset);
+
+	uint32 FrameDelta = 0;
+	Reader.SerializeIntPacked(FrameDelta);
+	Reader << PendingFrame;
+	Offset = Reader.Tell();
+
+	FramesUntilPending = FrameDelta;
+	return !Reader.IsError();
+}
+
+bool FGeoInputPlayer::NextFrame(FGeoInputFrame& OutFrame)
+{
+	if (bFinished) { return false; }
+
+	/** the input changes on this frame  */
+	while (bHasPending && FramesUntilPending == 0)
+	{
+		if (PendingFrame.Buttons & FGeoInputFrame::EndOfRecording)
+		{
+			bFinished = true;
+			return false;
+		}
+		CurrentFrame = PendingFrame;
+		bHasPending = ReadRecord();
+	}
+
+	if (FramesUntilPending > 0)
+	{
+		FramesUntilPending--;
+	}
+
+	OutFrame = CurrentFrame;
+	return true;
+}
+
+// -------------- F R A M E   T I M E S ----------------------------------------
+
+void FGeoFrameTimes::Tick()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (LastTime > 0.0)
+	{
+		FrameTimes.Add((float)((Now - LastTime) * 1000.0));
+	}
+	LastTime = Now;
+}
+
+void FGeoFrameTimes::Log(const TCHAR* Label) const
+{
+	if (FrameTimes.Num() == 0) { return; }
+
+	TArray<float> Sorted = FrameTimes;
+	Sorted.Sort();
+
+	auto Percentile = [&Sorted](float P) { return Sorted[FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)]; };
+
+	UE_LOG(LogTemp, Log, TEXT("%s frame times (%d frames): p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms"),
+		Label, Sorted.Num(), Percentile(0.5f), Percentile(0.9f), Percentile(0.99f), Sorted.Last());
+}
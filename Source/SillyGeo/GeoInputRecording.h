@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+/** Geo input of one frame, everything Geo needs to play the frame the way the player did */
+struct FGeoInputFrame
+{
+	/** button bits  */
+	enum : uint8
+	{
+		FireHeld = 1 << 0,
+		NextWeaponPressed = 1 << 1,
+		PreviousWeaponPressed = 1 << 2,
+
+		/** set only on the last record of the file  */
+		EndOfRecording = 1 << 7,
+	};
+
+	/** movement axes, -127..127  */
+	int8 MoveX = 0;
+	int8 MoveY = 0;
+
+	/** button bits  */
+	uint8 Buttons = 0;
+
+	/** aim direction (mouse deprojection), -32767..32767  */
+	int16 AimX = 0;
+	int16 AimY = 0;
+
+	static int8 QuantizeAxis(float Value) { return (int8)FMath::Clamp(FMath::RoundToInt(Value * 127.f), -127, 127); }
+	static float DequantizeAxis(int8 Value) { return Value / 127.f; }
+	static int16 QuantizeAim(float Value) { return (int16)FMath::Clamp(FMath::RoundToInt(Value * 32767.f), -32767, 32767); }
+	static float DequantizeAim(int16 Value) { return Value / 32767.f; }
+
+	bool operator==(const FGeoInputFrame& Other) const
+	{
+		return MoveX == Other.MoveX && MoveY == Other.MoveY && Buttons == Other.Buttons && AimX == Other.AimX && AimY == Other.AimY;
+	}
+	bool operator!=(const FGeoInputFrame& Other) const { return !(*this == Other); }
+
+	friend FArchive& operator<<(FArchive& Ar, FGeoInputFrame& Frame)
+	{
+		return Ar << Frame.MoveX << Frame.MoveY << Frame.Buttons << Frame.AimX << Frame.AimY;
+	}
+};
+
+/** the header of input recording file  */
+struct FGeoInputHeader
+{
+	static constexpr uint32 FileMagic = 0x494F4547; // "GEOI"
+	static constexpr uint16 FileVersion = 1;
+
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+
+	/** fixed step simulation settings of the recorded session  */
+	float StepRate = 60.f;
+	int32 Seed = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FGeoInputHeader& Header)
+	{
+		return Ar << Header.Magic << Header.Version << Header.StepRate << Header.Seed;
+	}
+
+	/** reads the header of specified file, returns false if it isn't a recording */
+	static bool Read(const FString& Path, FGeoInputHeader& OutHeader);
+
+	/** relative recording paths are relative to Saved/  */
+	static FString GetFullPath(const FString& Path);
+};
+
+/**
+*	records Geo input into compact binary file: a record is written only when the input changes
+*	(packed frame delta + 7 bytes). Records are gathered into memory chunks, full chunks
+*	are written to disk on the thread pool, so the game thread never waits for the disk
+*/
+class SILLYGEO_API FGeoInputRecorder
+{
+public:
+
+	~FGeoInputRecorder();
+
+	/** opens the file and writes the header  */
+	bool Start(const FString& Path, const FGeoInputHeader& Header);
+
+	/** [tick] records the input of the current frame  */
+	void Record(const FGeoInputFrame& Frame);
+
+	/** writes the end of recording and closes the file  */
+	void Stop();
+
+	/** returns the number of recorded frames  */
+	int32 GetNumFrames() const { return FrameIndex; }
+
+private:
+
+	/** hands the chunk over to the thread pool  */
+	void FlushChunk();
+
+	/** appends the record to the chunk  */
+	void WriteRecord(const FGeoInputFrame& Frame);
+
+	/** chunk size that triggers async write  */
+	static constexpr int32 ChunkSize = 16 * 1024;
+
+	TUniquePtr<FArchive> FileWriter;
+	TArray<uint8> Chunk;
+	TFuture<void> PendingWrite;
+
+	FGeoInputFrame LastFrame;
+	int32 FrameIndex = 0;
+	int32 LastRecordFrame = 0;
+};
+
+/** plays input recorded by FGeoInputRecorder frame by frame  */
+class SILLYGEO_API FGeoInputPlayer
+{
+public:
+
+	/** loads the whole recording, returns false if it can't be played */
+	bool Load(const FString& Path);
+
+	/** returns the input of the next frame, false when the recording is over */
+	bool NextFrame(FGeoInputFrame& OutFrame);
+
+	const FGeoInputHeader& GetHeader() const { return Header; }
+
+private:
+
+	/** reads next record from Data  */
+	bool ReadRecord();
+
+	FGeoInputHeader Header;
+	TArray<uint8> Data;
+	int32 Offset = 0;
+
+	FGeoInputFrame CurrentFrame;
+	FGeoInputFrame PendingFrame;
+
+	/** frames left to play before PendingFrame takes over  */
+	uint32 FramesUntilPending = 0;
+	bool bHasPending = false;
+	bool bFinished = false;
+};
+
+/** collects real (wall clock) frame times and logs their percentiles  */
+class SILLYGEO_API FGeoFrameTimes
+{
+public:
+
+	/** [tick] calls once a frame  */
+	void Tick();
+
+	/** logs p50 / p90 / p99 / max frame time (in ms)  */
+	void Log(const TCHAR* Label) const;
+
+	void Reset() { FrameTimes.Reset(); LastTime = 0.0; }
+
+private:
+
+	TArray<float> FrameTimes;
+	double LastTime = 0.0;
+};
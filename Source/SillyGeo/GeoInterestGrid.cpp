@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoInterestGrid.h"
+
+void FGeoInterestGrid::Init(float NewCellSize)
+{
+	CellSize = FMath::Max(NewCellSize, 1.f);
+	Cells.Empty();
+}
+
+void FGeoInterestGrid::Reset()
+{
+	for (TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+	{
+		Cell.Value.Reset();
+	}
+}
+
+void FGeoInterestGrid::Add(int32 Id, const FIntPoint& Cell)
+{
+	Cells.FindOrAdd(Cell).Add(Id);
+}
+
+void FGeoInterestGrid::Remove(int32 Id, const FIntPoint& Cell)
+{
+	if (TArray<int32>* Bucket = Cells.Find(Cell))
+	{
+		Bucket->RemoveSingleSwap(Id, false);
+	}
+}
+
+void FGeoInterestGrid::Move(int32 Id, const FIntPoint& From, const FIntPoint& To)
+{
+	if (From != To)
+	{
+		Remove(Id, From);
+		Add(Id, To);
+	}
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+*	buckets object ids into uniform 2D cells of the arena plane (Z is ignored), so callers look
+*	only at the cells around a point instead of at every object. Used by the server for
+*	per-connection interest and by the enemy spatial index.
+*	Distance between cells is measured in rings (Chebyshev distance)
+*/
+class SILLYGEO_API FGeoInterestGrid
+{
+public:
+
+	/** calls to set the cell size (in uu) and drop all buckets */
+	void Init(float NewCellSize);
+
+	/** empties every bucket, keeps allocations for the next frame  */
+	void Reset();
+
+	/** adds object id to the cell of specified location  */
+	void Add(int32 Id, const FVector& Location) { Add(Id, GetCell(Location)); }
+
+	/** adds object id to specified cell  */
+	void Add(int32 Id, const FIntPoint& Cell);
+
+	/** removes object id from specified cell, its bucket is kept for objects coming back  */
+	void Remove(int32 Id, const FIntPoint& Cell);
+
+	/** moves object id between cells, does nothing when they are the same  */
+	void Move(int32 Id, const FIntPoint& From, const FIntPoint& To);
+
+	/** returns cell size (in uu)  */
+	float GetCellSize() const { return CellSize; }
+
+	/** returns the cell of specified location  */
+	FIntPoint GetCell(const FVector& Location) const { return GetCell(FVector2D(Location)); }
+
+	/** returns the cell of specified location on the arena plane  */
+	FIntPoint GetCell(const FVector2D& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	}
+
+	/** returns how many rings of cells are between A and B, 0 for the same cell  */
+	static int32 GetCellDistance(const FIntPoint& A, const FIntPoint& B)
+	{
+		return FMath::Max(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y));
+	}
+
+	/** calls Func(Id, CellDistance) for every object within Radius rings around Center  */
+	template<typename FuncType>
+	void ForEachInRadius(const FIntPoint& Center, int32 Radius, FuncType Func) const
+	{
+		ForEachInRect(Center - FIntPoint(Radius, Radius), Center + FIntPoint(Radius, Radius), [&](int32 Id, const FIntPoint& Cell)
+		{
+			Func(Id, GetCellDistance(Center, Cell));
+		});
+	}
+
+	/** calls Func(Id, Cell) for every object in the cells from MinCell to MaxCell, both included  */
+	template<typename FuncType>
+	void ForEachInRect(const FIntPoint& MinCell, const FIntPoint& MaxCell, FuncType Func) const
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+			{
+				VisitCell(FIntPoint(X, Y), Func);
+			}
+		}
+	}
+
+	/** calls Func(Id, Cell) for every object in the cells exactly Ring rings away from Center  */
+	template<typename FuncType>
+	void ForEachInRing(const FIntPoint& Center, int32 Ring, FuncType Func) const
+	{
+		if (Ring == 0)
+		{
+			VisitCell(Center, Func);
+			return;
+		}
+
+		/** top and bottom rows, then left and right columns without corners */
+		for (int32 X = Center.X - Ring; X <= Center.X + Ring; X++)
+		{
+			VisitCell(FIntPoint(X, Center.Y - Ring), Func);
+			VisitCell(FIntPoint(X, Center.Y + Ring), Func);
+		}
+		for (int32 Y = Center.Y - Ring + 1; Y <= Center.Y + Ring - 1; Y++)
+		{
+			VisitCell(FIntPoint(Center.X - Ring, Y), Func);
+			VisitCell(FIntPoint(Center.X + Ring, Y), Func);
+		}
+	}
+
+private:
+
+	/** calls Func(Id, Cell) for every object in specified cell  */
+	template<typename FuncType>
+	void VisitCell(const FIntPoint& Cell, FuncType& Func) const
+	{
+		if (const TArray<int32>* Bucket = Cells.Find(Cell))
+		{
+			for (int32 Id : *Bucket)
+			{
+				Func(Id, Cell);
+			}
+		}
+	}
+
+	/** cell size (in uu)  */
+	float CellSize = 1024.f;
+
+	/** cell -> ids of objects inside  */
+	TMap<FIntPoint, TArray<int32>> Cells;
+};
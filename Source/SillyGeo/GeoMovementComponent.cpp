@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+UGeoMovementComponent::UGeoMovementComponent()
+{
+	/** 2D plane constraint  */
+	bConstrainToPlane = true;
+	bSnapToPlaneAtStart = true;
+	SetPlaneConstraintNormal(FVector(0.f, 0.f, 1.f));
+
+	/** needed for move RPCs  */
+	bReplicates = true;
+}
+
+void UGeoMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!PawnOwner || !UpdatedComponent || ShouldSkipUpdate(DeltaTime))
+	{
+		return;
+	}
+
+	/** remote pawns are moved by ServerMove (server) or by replicated movement (simulated proxies) */
+	if (!PawnOwner->IsLocallyControlled())
+	{
+		return;
+	}
+
+	/** quantize the input before we use it so that server simulates exactly the same move */
+	const FVector InputVector = ConsumeInputVector();
+	const uint16 PackedInput = PackInput(InputVector);
+	PerformMove(UnpackInput(PackedInput), DeltaTime);
+
+	if (PawnOwner->Role == ROLE_AutonomousProxy)
+	{
+		FGeoSavedMove Move;
+		Move.Timestamp = GetWorld()->GetTimeSeconds();
+		Move.DeltaTime = DeltaTime;
+		Move.PackedInput = PackedInput;
+
+		if (SavedMoves.Num() >= MaxSavedMoves)
+		{
+			SavedMoves.RemoveAt(0, 1, false);
+		}
+		SavedMoves.Add(Move);
+
+		ServerMove(Move.Timestamp, PackedInput, UpdatedComponent->GetComponentLocation());
+	}
+}
+
+void UGeoMovementComponent::PerformMove(const FVector2D& Input, float DeltaTime)
+{
+	if (!UpdatedComponent || DeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	const FVector Acceleration = FVector(Input.GetClampedToMaxSize(1.f), 0.f) * MaxAcceleration;
+	if (!Acceleration.IsNearlyZero())
+	{
+		/** accelerate  */
+		Velocity = (Velocity + Acceleration * DeltaTime).GetClampedToMaxSize(MaxSpeed);
+	}
+	else
+	{
+		/** brake  */
+		const float Speed = Velocity.Size();
+		const float NewSpeed = FMath::Max(Speed - BrakingDeceleration * DeltaTime, 0.f);
+		Velocity = Speed > KINDA_SMALL_NUMBER ? Velocity * (NewSpeed / Speed) : FVector::ZeroVector;
+	}
+	Velocity.Z = 0.f;
+
+	const FVector Delta = Velocity * DeltaTime;
+	if (!Delta.IsNearlyZero())
+	{
+		FHitResult Hit;
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+		/** slide along walls instead of sticking to them  */
+		if (Hit.IsValidBlockingHit())
+		{
+			SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+		}
+	}
+
+	UpdateComponentVelocity();
+}
+
+bool UGeoMovementComponent::ServerMove_Validate(float Timestamp, uint16 PackedInput, FVector_NetQuantize ClientLocation)
+{
+	return !ClientLocation.ContainsNaN();
+}
+
+void UGeoMovementComponent::ServerMove_Implementation(float Timestamp, uint16 PackedInput, FVector_NetQuantize ClientLocation)
+{
+	/** old or reordered move  */
+	if (Timestamp <= LastServerTimestamp || !UpdatedComponent)
+	{
+		return;
+	}
+
+	const float DeltaTime = LastServerTimestamp < 0.f ? 0.f : FMath::Min(Timestamp - LastServerTimestamp, MaxMoveDeltaTime);
+	LastServerTimestamp = Timestamp;
+
+	PerformMove(UnpackInput(PackedInput), DeltaTime);
+
+	/** correct the client only if its prediction went wrong  */
+	const FVector ServerLocation = UpdatedComponent->GetComponentLocation();
+	if ((ServerLocation - ClientLocation).SizeSquared2D() > FMath::Square(MaxPositionError))
+	{
+		ClientAdjustPosition(Timestamp, ServerLocation, Velocity);
+	}
+}
+
+void UGeoMovementComponent::ClientAdjustPosition_Implementation(float Timestamp, FVector_NetQuantize NewLocation, FVector_NetQuantize10 NewVelocity)
+{
+	if (!UpdatedComponent)
+	{
+		return;
+	}
+
+	UpdatedComponent->SetWorldLocation(NewLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	Velocity = NewVelocity;
+
+	/** drop the corrected moves and replay the rest on top of the server state  */
+	int32 CorrectedMoves = 0;
+	while (CorrectedMoves < SavedMoves.Num() && SavedMoves[CorrectedMoves].Timestamp <= Timestamp)
+	{
+		CorrectedMoves++;
+	}
+	SavedMoves.RemoveAt(0, CorrectedMoves, false);
+
+	for (const FGeoSavedMove& Move : SavedMoves)
+	{
+		PerformMove(UnpackInput(Move.PackedInput), Move.DeltaTime);
+	}
+}
+
+uint16 UGeoMovementComponent::PackInput(const FVector& Input)
+{
+	const int8 X = (int8)FMath::RoundToInt(FMath::Clamp(Input.X, -1.f, 1.f) * 127.f);
+	const int8 Y = (int8)FMath::RoundToInt(FMath::Clamp(Input.Y, -1.f, 1.f) * 127.f);
+	return (uint16)(uint8)X | ((uint16)(uint8)Y << 8);
+}
+
+FVector2D UGeoMovementComponent::UnpackInput(uint16 PackedInput)
+{
+	const int8 X = (int8)(PackedInput & 0xFF);
+	const int8 Y = (int8)(PackedInput >> 8);
+	return FVector2D(X / 127.f, Y / 127.f);
+}
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "Engine/NetSerialization.h"
+#include "GeoMovementComponent.generated.h"
+
+/** a single locally predicted move, kept until the server had a chance to correct it */
+struct FGeoSavedMove
+{
+	/** client time stamp of this move  */
+	float Timestamp = 0.f;
+
+	/** delta time this move was simulated with  */
+	float DeltaTime = 0.f;
+
+	/** quantized 2D input ( see UGeoMovementComponent::PackInput )  */
+	uint16 PackedInput = 0;
+};
+
+/**
+*	lightweight movement for Geo on the Z=0 plane:
+*	acceleration / braking only, no walking, stepping or gravity.
+*	The owning client predicts its moves and sends them to the server
+*	as compact packed input, the server corrects it only when the
+*	resulting positions diverge
+*/
+UCLASS(ClassGroup = Movement, meta = (BlueprintSpawnableComponent))
+class SILLYGEO_API UGeoMovementComponent : public UPawnMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UGeoMovementComponent();
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	virtual float GetMaxSpeed() const override { return MaxSpeed; }
+
+	/** calls to advance velocity and position by one move with specified input  */
+	void PerformMove(const FVector2D& Input, float DeltaTime);
+
+	/** the maximum speed on the plane  */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	float MaxSpeed = 600.f;
+
+	/** acceleration applied while there is input  */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	float MaxAcceleration = 1024.f;
+
+	/** deceleration applied while there is no input  */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	float BrakingDeceleration = 2000.f;
+
+	/** position error (in uu) the server tolerates before it corrects the client */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network")
+	float MaxPositionError = 3.f;
+
+	/** the longest time span a single client move is allowed to cover  */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network")
+	float MaxMoveDeltaTime = 0.125f;
+
+	/** how many unacknowledged moves the client keeps to replay after a correction */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network")
+	int32 MaxSavedMoves = 64;
+
+protected:
+
+	/** client -> server : one predicted move  */
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerMove(float Timestamp, uint16 PackedInput, FVector_NetQuantize ClientLocation);
+
+	/** server -> client : authoritative state after the move with specified time stamp  */
+	UFUNCTION(Client, Unreliable)
+	void ClientAdjustPosition(float Timestamp, FVector_NetQuantize NewLocation, FVector_NetQuantize10 NewVelocity);
+
+private:
+
+	/** packs [-1, 1] 2D input into two signed bytes  */
+	static uint16 PackInput(const FVector& Input);
+
+	/** unpacks input packed by PackInput  */
+	static FVector2D UnpackInput(uint16 PackedInput);
+
+	/** moves predicted by the client and not yet corrected by the server  */
+	TArray<FGeoSavedMove> SavedMoves;
+
+	/** [server] time stamp of the last processed client move  */
+	float LastServerTimestamp = -1.f;
+};
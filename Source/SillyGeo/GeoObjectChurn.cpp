@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoObjectChurn.h"
+#include "UObject/UObjectBase.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/Class.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/PlatformTime.h"
+
+FGeoObjectChurnTracker::~FGeoObjectChurnTracker()
+{
+	Stop();
+}
+
+void FGeoObjectChurnTracker::Start()
+{
+	if (bListening) { return; }
+
+	GUObjectArray.AddUObjectCreateListener(this);
+	GUObjectArray.AddUObjectDeleteListener(this);
+	PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FGeoObjectChurnTracker::OnPreGarbageCollect);
+	PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FGeoObjectChurnTracker::OnPostGarbageCollect);
+	bListening = true;
+}
+
+void FGeoObjectChurnTracker::Stop()
+{
+	if (!bListening) { return; }
+
+	GUObjectArray.RemoveUObjectCreateListener(this);
+	GUObjectArray.RemoveUObjectDeleteListener(this);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+	bListening = false;
+
+	if (CurrentWave > 0)
+	{
+		LogWave();
+	}
+}
+
+void FGeoObjectChurnTracker::BeginWave(int32 Wave)
+{
+	if (CurrentWave > 0)
+	{
+		LogWave();
+	}
+
+	{
+		FScopeLock Lock(&ClassChurnLock);
+		ClassChurn.Reset();
+	}
+	CombatGC = FGCPasses();
+	RestGC = FGCPasses();
+	CurrentWave = Wave;
+	bCombat = true;
+}
+
+void FGeoObjectChurnTracker::LogWave() const
+{
+	TArray<TPair<FName, FClassChurn>> Classes;
+	int32 Created = 0;
+	int32 Destroyed = 0;
+	{
+		FScopeLock Lock(&ClassChurnLock);
+		for (const TPair<FName, FClassChurn>& Pair : ClassChurn)
+		{
+			Classes.Add(Pair);
+			Created += Pair.Value.Created;
+			Destroyed += Pair.Value.Destroyed;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Wave %d object churn: created %d, destroyed %d, GC combat %d passes %.2f ms (max %.2f ms), GC rest %d passes %.2f ms (max %.2f ms)"),
+		CurrentWave, Created, Destroyed,
+		CombatGC.Num, CombatGC.TotalMs, CombatGC.MaxMs,
+		RestGC.Num, RestGC.TotalMs, RestGC.MaxMs);
+
+	/** the most churning classes first  */
+	Classes.Sort([](const TPair<FName, FClassChurn>& A, const TPair<FName, FClassChurn>& B)
+	{
+		return A.Value.Created + A.Value.Destroyed > B.Value.Created + B.Value.Destroyed;
+	});
+	for (int32 i = 0; i < Classes.Num() && i < MaxClassesToLog; i++)
+	{
+		UE_LOG(LogTemp, Log, TEXT("    %s: created %d, destroyed %d"), *Classes[i].Key.ToString(), Classes[i].Value.Created, Classes[i].Value.Destroyed);
+	}
+}
+
+void FGeoObjectChurnTracker::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	const UClass* Class = Object ? Object->GetClass() : nullptr;
+	if (!Class) { return; }
+
+	FScopeLock Lock(&ClassChurnLock);
+	ClassChurn.FindOrAdd(Class->GetFName()).Created++;
+}
+
+void FGeoObjectChurnTracker::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index)
+{
+	const UClass* Class = Object ? Object->GetClass() : nullptr;
+	if (!Class) { return; }
+
+	FScopeLock Lock(&ClassChurnLock);
+	ClassChurn.FindOrAdd(Class->GetFName()).Destroyed++;
+}
+
+void FGeoObjectChurnTracker::OnPreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void FGeoObjectChurnTracker::OnPostGarbageCollect()
+{
+	/** mark and the first purge step, incremental purge of the rest is spread over next frames */
+	const double Ms = (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+	(bCombat ? CombatGC : RestGC).Add(Ms);
+
+	UE_LOG(LogTemp, Log, TEXT("GC pass %.2f ms (wave %d, %s)"), Ms, CurrentWave, bCombat ? TEXT("combat") : TEXT("rest"));
+}
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UObjectArray.h"
+#include "HAL/CriticalSection.h"
+
+/**
+*	counts UObjects created and destroyed per class and times garbage collection passes,
+*	everything is split by waves: a wave lasts from its start till the next wave starts,
+*	so objects destroyed by GC during the rest after the wave are counted for that wave
+*/
+class SILLYGEO_API FGeoObjectChurnTracker : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+{
+public:
+
+	~FGeoObjectChurnTracker();
+
+	/** starts listening to the object array and the garbage collector  */
+	void Start();
+
+	/** logs the current wave and stops listening  */
+	void Stop();
+
+	/** logs the previous wave and starts counting the next one  */
+	void BeginWave(int32 Wave);
+
+	/** calls when combat of the current wave ends and the rest begins  */
+	void EndCombat() { bCombat = false; }
+
+	/** logs created / destroyed objects of the most churning classes and GC passes of the current wave */
+	void LogWave() const;
+
+	/** FUObjectCreateListener, may be called from async loading thread  */
+	virtual void NotifyUObjectCreated(const class UObjectBase* Object, int32 Index) override;
+
+	/** FUObjectDeleteListener  */
+	virtual void NotifyUObjectDeleted(const class UObjectBase* Object, int32 Index) override;
+
+	/** classes to log at the end of every wave  */
+	int32 MaxClassesToLog = 8;
+
+private:
+
+	/** GC delegates  */
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	struct FClassChurn
+	{
+		int32 Created = 0;
+		int32 Destroyed = 0;
+	};
+
+	/** GC passes of one part of the wave  */
+	struct FGCPasses
+	{
+		int32 Num = 0;
+		double TotalMs = 0.0;
+		double MaxMs = 0.0;
+
+		void Add(double Ms) { Num++; TotalMs += Ms; MaxMs = FMath::Max(MaxMs, Ms); }
+	};
+
+	/** guards ClassChurn  */
+	mutable FCriticalSection ClassChurnLock;
+	TMap<FName, FClassChurn> ClassChurn;
+
+	FGCPasses CombatGC;
+	FGCPasses RestGC;
+
+	FDelegateHandle PreGCHandle;
+	FDelegateHandle PostGCHandle;
+	double GCStartTime = 0.0;
+
+	int32 CurrentWave = 0;
+	bool bCombat = false;
+	bool bListening = false;
+};
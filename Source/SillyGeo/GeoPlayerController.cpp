@@ -1,7 +1,63 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "GeoPlayerController.h"
+#include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
+#include "GeoGameState.h"
+#include "Geo.h"
 
+void AGeoPlayerController::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+	DOREPLIFETIME_CONDITION(AGeoPlayerController, RelevantEnemies, COND_OwnerOnly);
+}
 
+void AGeoPlayerController::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
 
+	RelevantEnemies.Owner = this;
+}
+
+void AGeoPlayerController::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	const AGeoGameState* GeoGameState = GetWorld()->GetGameState<AGeoGameState>();
+	const bool bInterestManagement = GeoGameState && GeoGameState->UsesInterestManagement();
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGeoPlayerController, RelevantEnemies, bInterestManagement);
+
+	/** keep the enemies around our view up to date, local controllers see the real enemies  */
+	if (bInterestManagement && !IsLocalController())
+	{
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		GetPlayerViewPoint(ViewLocation, ViewRotation);
+		if (GetPawn())
+		{
+			ViewLocation = GetPawn()->GetActorLocation();
+		}
+
+		GeoGameState->UpdateRelevantEnemies(ViewLocation, RelevantEnemies, RelevantEnemyIndices, InterestUpdateCounter++);
+	}
+}
+
+void AGeoPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	if (AGeo* Geo = Cast<AGeo>(GetPawn()))
+	{
+		Geo->ProcessInputFrame();
+	}
+}
+
+void AGeoPlayerController::ClientSimulateFire_Implementation(class AGeo* Shooter, FGeoFireEvent FireEvent)
+{
+	/** the shooter isn't relevant to us  */
+	if (Shooter)
+	{
+		Shooter->SimulateRemoteFire(FireEvent);
+	}
+}
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "EnemyNetState.h"
+#include "GeoFireEvent.h"
 #include "GeoPlayerController.generated.h"
 
 /**
@@ -16,6 +18,17 @@ class SILLYGEO_API AGeoPlayerController : public APlayerController
 	
 public:
 
+	virtual void PostInitializeComponents() override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** hands the input of this frame to our Geo once input bindings have fired  */
+	virtual void PlayerTick(float DeltaTime) override;
+
+	/** server -> owning client : shot of another player near us to simulate locally  */
+	UFUNCTION(Client, Unreliable)
+	void ClientSimulateFire(class AGeo* Shooter, FGeoFireEvent FireEvent);
+
 	/** calls to update the HUD  */
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable, Category = "AAA")
 	void UpdateHUD();
@@ -33,6 +46,14 @@ protected:
 
 
 private:
-	
-	
+
+	/** enemies near our Geo, replicated only to our connection with interest management */
+	UPROPERTY(Replicated)
+	FEnemyNetArray RelevantEnemies;
+
+	/** [server] enemy id -> index in RelevantEnemies  */
+	TMap<int32, int32> RelevantEnemyIndices;
+
+	/** [server] the number of net updates of this connection  */
+	uint32 InterestUpdateCounter = 0;
 };
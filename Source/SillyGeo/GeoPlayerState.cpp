@@ -2,6 +2,9 @@
 
 #include "GeoPlayerState.h"
 #include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "SillyGeoStats.h"
 
 /** Returns properties that are replicated for the lifetime of the actor channel */
 void AGeoPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -11,3 +14,48 @@ void AGeoPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutL
 	DOREPLIFETIME(AGeoPlayerState, EnemiesKilled);
 }
 
+void AGeoPlayerState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	/** flush kills batched since the last net update  */
+	const float Time = GetWorld()->GetTimeSeconds();
+	if (PendingKills != 0)
+	{
+		EnemiesKilled += PendingKills;
+		PendingKills = 0;
+		EnemiesKilledActiveUntil = Time + DirtyReplicationTime;
+	}
+
+	const bool bEnemiesKilledActive = Time <= EnemiesKilledActiveUntil;
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGeoPlayerState, EnemiesKilled, bEnemiesKilledActive);
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!bEnemiesKilledActive && NetDriver && NetDriver->ClientConnections.Num() > 0)
+	{
+		INC_DWORD_STAT(STAT_SkippedRepCompares);
+	}
+}
+
+void AGeoPlayerState::AddEnemiesKilled(int32 Amount)
+{
+	/** nobody to replicate to  */
+	if (GetNetMode() == NM_Standalone)
+	{
+		EnemiesKilled += Amount;
+		return;
+	}
+
+	/** the first kill of the batch asks for net update, the rest join it  */
+	if (PendingKills == 0)
+	{
+		ForceNetUpdate();
+	}
+	PendingKills += Amount;
+}
+
+void AGeoPlayerState::MarkEnemiesKilledDirty()
+{
+	EnemiesKilledActiveUntil = GetWorld()->GetTimeSeconds() + DirtyReplicationTime;
+	ForceNetUpdate();
+}
@@ -16,9 +16,30 @@ class SILLYGEO_API AGeoPlayerState : public APlayerState
 			
 public:
 
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** [server] calls to add killed enemies, kills of one net update are sent together */
+	void AddEnemiesKilled(int32 Amount);
+
+	/** [server] calls to send the kill counter again, e.g. to a player who just joined */
+	void MarkEnemiesKilledDirty();
+
+	/** returns how many enemies was killed by our player  */
+	FORCEINLINE int32 GetEnemiesKilled() const { return EnemiesKilled + PendingKills; }
+
+private:
+
 	/** shows how many enemies was killed by our player  */
 	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	int32 EnemiesKilled = 0;
+
+	/** [server] kills added since the last net update  */
+	int32 PendingKills = 0;
 	
-	
+	/** [server] the time EnemiesKilled stops to be compared for replication  */
+	float EnemiesKilledActiveUntil = 0.f;
+
+	/** how long (in sec) changed kill counter stays active for replication  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (AllowPrivateAccess = "true"))
+	float DirtyReplicationTime = 1.f;
 };
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoQualityGovernor.h"
+
+void FGeoQualityGovernor::Init(const TArray<FGeoQualitySettings>& InTiers)
+{
+	Tiers = InTiers;
+	if (Tiers.Num() == 0)
+	{
+		Tiers.AddDefaulted();
+		Tiers[0].Name = TEXT("Default");
+	}
+	TierSeconds.Reset();
+	TierSeconds.SetNumZeroed(Tiers.Num());
+
+	Tier = 0;
+	AvgFrameMs = 0.f;
+	LastTickTime = 0.0;
+	TierChangeTime = 0.0;
+	ExplosionBudget = FGeoExplosionBudget();
+}
+
+bool FGeoQualityGovernor::Tick(float FrameMs, int32 Entities, double Now)
+{
+	if (Tiers.Num() == 0) { return false; }
+
+	if (LastTickTime > 0.0)
+	{
+		TierSeconds[Tier] += Now - LastTickTime;
+	}
+	else
+	{
+		/** the first frame carries the map load  */
+		LastTickTime = Now;
+		TierChangeTime = Now;
+		return false;
+	}
+	LastTickTime = Now;
+
+	/** exponential average over AverageWindow, long frames weigh more */
+	const float Alpha = FMath::Clamp(FrameMs / (FMath::Max(AverageWindow, 0.01f) * 1000.f), 0.f, 1.f);
+	AvgFrameMs = AvgFrameMs > 0.f ? FMath::Lerp(AvgFrameMs, FrameMs, Alpha) : FrameMs;
+
+	if (Now - TierChangeTime < MinTierTime) { return false; }
+
+	const FGeoQualitySettings& Current = Tiers[Tier];
+	const bool bOverBudget = AvgFrameMs > TargetFrameMs * DownRatio || (Current.MaxEntities > 0 && Entities > Current.MaxEntities);
+
+	int32 NewTier = Tier;
+	if (bOverBudget)
+	{
+		NewTier = FMath::Min(Tier + 1, Tiers.Num() - 1);
+	}
+	else if (Tier > 0)
+	{
+		const FGeoQualitySettings& Better = Tiers[Tier - 1];
+		const bool bUnderBudget = AvgFrameMs < TargetFrameMs * UpRatio && (Better.MaxEntities == 0 || Entities < Better.MaxEntities * UpRatio);
+		if (bUnderBudget)
+		{
+			NewTier = Tier - 1;
+		}
+	}
+
+	if (NewTier == Tier) { return false; }
+
+	UE_LOG(LogTemp, Log, TEXT("Quality tier %s -> %s (avg frame %.1f ms, %d entities)"), *Tiers[Tier].Name, *Tiers[NewTier].Name, AvgFrameMs, Entities);
+
+	Tier = NewTier;
+	TierChangeTime = Now;
+	ExplosionBudget.Tokens = FMath::Min(ExplosionBudget.Tokens, (float)Tiers[Tier].MaxExplosionsPerSecond);
+	return true;
+}
+
+bool FGeoExplosionBudget::Consume(int32 MaxPerSecond, double Now)
+{
+	if (MaxPerSecond <= 0) { return true; }
+
+	/** a fresh bucket starts full  */
+	Tokens = RefillTime > 0.0 ? FMath::Min(Tokens + (float)((Now - RefillTime) * MaxPerSecond), (float)MaxPerSecond) : (float)MaxPerSecond;
+	RefillTime = Now;
+	if (Tokens < 1.f) { return false; }
+
+	Tokens -= 1.f;
+	return true;
+}
+
+bool FGeoQualityGovernor::ConsumeExplosion(double Now)
+{
+	return Tiers.Num() == 0 || ExplosionBudget.Consume(Tiers[Tier].MaxExplosionsPerSecond, Now);
+}
+
+void FGeoQualityGovernor::LogTierTimes() const
+{
+	FString Times;
+	for (int32 i = 0; i < Tiers.Num(); i++)
+	{
+		Times += FString::Printf(TEXT("%s%s %.1f s"), i > 0 ? TEXT(", ") : TEXT(""), *Tiers[i].Name, TierSeconds[i]);
+	}
+	UE_LOG(LogTemp, Log, TEXT("Quality tiers: %s"), *Times);
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeoQualityGovernor.generated.h"
+
+/** what one quality tier keeps of cosmetic costs  */
+USTRUCT(BlueprintType)
+struct FGeoQualitySettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** the name of the tier in logs and reports  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	FString Name;
+
+	/** scale of Geo world sparks spawn rate ( SpawnRateScale emitter parameter ), 0 - sparks are off */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	float SparksSpawnScale = 1.f;
+
+	/** scale of Geo trail spawn rate  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	float TrailSpawnScale = 1.f;
+
+	/** scale of projectile trail spawn rate  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	float ProjectileTrailSpawnScale = 1.f;
+
+	/** enemy and projectile explosion emitters a second, 0 - unlimited */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	int32 MaxExplosionsPerSecond = 0;
+
+	/** if false, projectiles don't light the arena  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	bool bProjectileLights = true;
+
+	/** if false, enemy materials don't pulse ( PulseScale material parameter ) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	bool bEnemyPulse = true;
+
+	/** live enemies and projectiles the tier holds before the governor steps down, 0 - any amount */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quality")
+	int32 MaxEntities = 0;
+};
+
+/** token bucket of explosion emitters, holds one second worth of explosions at most */
+struct FGeoExplosionBudget
+{
+	float Tokens = 0.f;
+	double RefillTime = 0.0;
+
+	/** returns true if one more explosion fits into MaxPerSecond, 0 - unlimited */
+	bool Consume(int32 MaxPerSecond, double Now);
+};
+
+/**
+*	picks the quality tier from the rolling average of frame time and live enemies and projectiles.
+*	Steps down one tier when the average is over the target or there are too many entities for the tier,
+*	steps up when both are well under, and holds every tier for MinTierTime, so it doesn't flicker
+*/
+class SILLYGEO_API FGeoQualityGovernor
+{
+public:
+
+	/** tier 0 is the best one  */
+	void Init(const TArray<FGeoQualitySettings>& InTiers);
+
+	/** [game thread] calls once per frame, returns true if the tier changed */
+	bool Tick(float FrameMs, int32 Entities, double Now);
+
+	int32 GetTier() const { return Tier; }
+
+	const FGeoQualitySettings& GetSettings() const { return Tiers[Tier]; }
+
+	const TArray<FGeoQualitySettings>& GetTiers() const { return Tiers; }
+
+	/** returns true if one more explosion emitter fits into the budget of the tier */
+	bool ConsumeExplosion(double Now);
+
+	/** logs how long the game stayed in every tier  */
+	void LogTierTimes() const;
+
+	/** frame time (in ms) the governor keeps the average under  */
+	float TargetFrameMs = 16.7f;
+
+	/** steps down when the average is over TargetFrameMs * DownRatio  */
+	float DownRatio = 1.15f;
+
+	/** steps up when the average is under TargetFrameMs * UpRatio and entities are under MaxEntities * UpRatio of the better tier */
+	float UpRatio = 0.8f;
+
+	/** the window (in sec) of the rolling average  */
+	float AverageWindow = 1.f;
+
+	/** min time (in sec) between two tier changes  */
+	float MinTierTime = 2.f;
+
+private:
+
+	TArray<FGeoQualitySettings> Tiers;
+
+	/** seconds spent in every tier  */
+	TArray<double> TierSeconds;
+
+	int32 Tier = 0;
+	float AvgFrameMs = 0.f;
+	double LastTickTime = 0.0;
+	double TierChangeTime = 0.0;
+
+	FGeoExplosionBudget ExplosionBudget;
+};
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoSpawnDirector.h"
+
+void FGeoSpawnDirector::BeginWave(float InBaseInterval)
+{
+	/** the load of the previous wave is kept, so a heavy wave doesn't start at full speed */
+	BaseInterval = FMath::Max(InBaseInterval, KINDA_SMALL_NUMBER);
+	SpawnInterval = FMath::Clamp(SpawnInterval, BaseInterval, BaseInterval * MaxSlowdown);
+	AliveCap = 0;
+	TimeSinceDecision = 0.f;
+}
+
+bool FGeoSpawnDirector::Update(float GameThreadMs, int32 AliveEnemies, float DeltaSeconds)
+{
+	const float Alpha = FMath::Clamp(DeltaSeconds / FMath::Max(AverageWindow, 0.01f), 0.f, 1.f);
+	AvgGameThreadMs = AvgGameThreadMs > 0.f ? FMath::Lerp(AvgGameThreadMs, GameThreadMs, Alpha) : GameThreadMs;
+
+	TimeSinceDecision += DeltaSeconds;
+	if (TimeSinceDecision < DecisionInterval) { return false; }
+	TimeSinceDecision = 0.f;
+
+	const float PrevInterval = SpawnInterval;
+	const int32 PrevCap = AliveCap;
+
+	if (AvgGameThreadMs > TargetGameThreadMs)
+	{
+		/** slow down and hold the alive enemies a bit under what we have now */
+		SpawnInterval = FMath::Min(SpawnInterval * 1.25f, BaseInterval * MaxSlowdown);
+		const int32 Alive = AliveCap > 0 ? FMath::Min(AliveCap, AliveEnemies) : AliveEnemies;
+		AliveCap = FMath::Max(MinAliveCap, FMath::FloorToInt(Alive * 0.9f));
+	}
+	else if (AvgGameThreadMs < TargetGameThreadMs * RecoverRatio)
+	{
+		SpawnInterval = FMath::Max(SpawnInterval / 1.25f, BaseInterval);
+		if (AliveCap > 0)
+		{
+			/** the cap is far from the alive enemies, it doesn't limit anything anymore */
+			AliveCap = AliveEnemies < AliveCap / 2 ? 0 : AliveCap + FMath::Max(1, AliveCap / 10);
+		}
+	}
+
+	return !FMath::IsNearlyEqual(SpawnInterval, PrevInterval) || AliveCap != PrevCap;
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+*	[server] paces enemy spawning by measured game thread time. The wave still spawns all its enemies,
+*	but while the average is over the target the director stretches the spawn interval (up to MaxSlowdown
+*	times SpawnDelay) and caps concurrent alive enemies, then gives both back as the load drops
+*/
+class SILLYGEO_API FGeoSpawnDirector
+{
+public:
+
+	/** starts pacing the wave from its wave table spawn delay  */
+	void BeginWave(float InBaseInterval);
+
+	/** calls once per frame, returns true if the interval or the cap changed */
+	bool Update(float GameThreadMs, int32 AliveEnemies, float DeltaSeconds);
+
+	/** returns true if one more enemy may be alive  */
+	bool CanSpawn(int32 AliveEnemies) const { return AliveCap <= 0 || AliveEnemies < AliveCap; }
+
+	/** returns the time (in sec) between two spawns  */
+	float GetSpawnInterval() const { return SpawnInterval; }
+
+	/** returns the max of concurrent alive enemies, 0 - no cap */
+	int32 GetAliveCap() const { return AliveCap; }
+
+	/** returns rolling average of game thread time in ms  */
+	float GetAvgGameThreadMs() const { return AvgGameThreadMs; }
+
+	/** game thread time (in ms) the director keeps the average under  */
+	float TargetGameThreadMs = 10.f;
+
+	/** the longest spawn interval as a multiple of SpawnDelay  */
+	float MaxSlowdown = 4.f;
+
+	/** the cap never goes below this amount of alive enemies  */
+	int32 MinAliveCap = 10;
+
+	/** spawning recovers when the average is under TargetGameThreadMs * RecoverRatio */
+	float RecoverRatio = 0.8f;
+
+	/** the window (in sec) of the rolling average  */
+	float AverageWindow = 0.5f;
+
+	/** how often (in sec) the director makes a decision  */
+	float DecisionInterval = 0.5f;
+
+private:
+
+	float BaseInterval = 1.f;
+	float SpawnInterval = 1.f;
+	int32 AliveCap = 0;
+	float AvgGameThreadMs = 0.f;
+	float TimeSinceDecision = 0.f;
+};
@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoTelemetry.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/World.h"
+
+const TCHAR* FGeoTelemetryEvent::GetTypeName(EGeoTelemetryEvent Type)
+{
+	switch (Type)
+	{
+	case EGeoTelemetryEvent::MatchStart:	return TEXT("MatchStart");
+	case EGeoTelemetryEvent::MatchEnd:		return TEXT("MatchEnd");
+	case EGeoTelemetryEvent::WaveStart:		return TEXT("WaveStart");
+	case EGeoTelemetryEvent::WaveEnd:		return TEXT("WaveEnd");
+	case EGeoTelemetryEvent::EnemySpawned:	return TEXT("EnemySpawned");
+	case EGeoTelemetryEvent::EnemyKilled:	return TEXT("EnemyKilled");
+	case EGeoTelemetryEvent::PlayerKills:	return TEXT("PlayerKills");
+	case EGeoTelemetryEvent::GeoDamaged:	return TEXT("GeoDamaged");
+	case EGeoTelemetryEvent::Frames:		return TEXT("Frames");
+	case EGeoTelemetryEvent::SpawnDirector:	return TEXT("SpawnDirector");
+	}
+	return TEXT("Unknown");
+}
+
+FString FGeoTelemetryEvent::ToJson() const
+{
+	FString Json = FString::Printf(TEXT("{\"t\":%.3f,\"e\":\"%s\",\"wave\":%d"), Time, GetTypeName(Type), Wave);
+	if (Player != INDEX_NONE)
+	{
+		Json += FString::Printf(TEXT(",\"player\":%d"), Player);
+	}
+
+	switch (Type)
+	{
+	case EGeoTelemetryEvent::WaveStart:
+		Json += FString::Printf(TEXT(",\"enemies\":%d"), (int32)Value[0]);
+		break;
+	case EGeoTelemetryEvent::WaveEnd:
+		Json += FString::Printf(TEXT(",\"duration\":%.3f"), Value[0]);
+		break;
+	case EGeoTelemetryEvent::EnemySpawned:
+	case EGeoTelemetryEvent::EnemyKilled:
+		Json += FString::Printf(TEXT(",\"enemy\":\"%s\""), *Name.ToString());
+		break;
+	case EGeoTelemetryEvent::PlayerKills:
+		Json += FString::Printf(TEXT(",\"kills\":%d"), (int32)Value[0]);
+		break;
+	case EGeoTelemetryEvent::GeoDamaged:
+		Json += FString::Printf(TEXT(",\"damage\":%.2f,\"health\":%.2f"), Value[0], Value[1]);
+		break;
+	case EGeoTelemetryEvent::Frames:
+		Json += FString::Printf(TEXT(",\"frames\":%d,\"avg_ms\":%.2f,\"max_ms\":%.2f,\"gt_ms\":%.2f"), (int32)Value[0], Value[1], Value[2], Value[3]);
+		break;
+	case EGeoTelemetryEvent::SpawnDirector:
+		Json += FString::Printf(TEXT(",\"interval\":%.3f,\"alive_cap\":%d,\"gt_ms\":%.2f"), Value[0], (int32)Value[1], Value[2]);
+		break;
+	default:
+		if (!Name.IsNone())
+		{
+			Json += FString::Printf(TEXT(",\"name\":\"%s\""), *Name.ToString());
+		}
+		break;
+	}
+
+	Json += TEXT("}");
+	return Json;
+}
+
+FGeoTelemetry::~FGeoTelemetry()
+{
+	Close();
+}
+
+bool FGeoTelemetry::Open(const FString& Path, const UWorld* InWorld)
+{
+	Close();
+
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!FileWriter)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to create telemetry %s"), *Path);
+		return false;
+	}
+
+	World = InWorld;
+	CurrentWave = 0;
+	NumFrames = 0;
+	bStopping = false;
+	LastFlushTime = FPlatformTime::Seconds();
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("GeoTelemetryWriter"), 0, TPri_BelowNormal);
+
+	UE_LOG(LogTemp, Log, TEXT("Telemetry: writing %s"), *Path);
+	return true;
+}
+
+void FGeoTelemetry::Close()
+{
+	if (Thread)
+	{
+		/** Run drains and flushes the rest before it returns  */
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+
+	FileWriter.Reset();
+	World = nullptr;
+}
+
+void FGeoTelemetry::Push(EGeoTelemetryEvent Type, int32 Player, FName Name, float Value0, float Value1, float Value2)
+{
+	if (!Thread) { return; }
+
+	FGeoTelemetryEvent Event;
+	Event.Type = Type;
+	Event.Time = World ? World->GetTimeSeconds() : 0.f;
+	Event.Wave = CurrentWave;
+	Event.Player = Player;
+	Event.Name = Name;
+	Event.Value[0] = Value0;
+	Event.Value[1] = Value1;
+	Event.Value[2] = Value2;
+	Queue.Enqueue(Event);
+}
+
+void FGeoTelemetry::AddFrame(float FrameMs, float GameThreadMs)
+{
+	if (!Thread || !World) { return; }
+
+	const float Time = World->GetTimeSeconds();
+	if (NumFrames == 0)
+	{
+		FramesStartTime = Time;
+		TotalFrameMs = 0.f;
+		MaxFrameMs = 0.f;
+		TotalGameThreadMs = 0.f;
+	}
+
+	NumFrames++;
+	TotalFrameMs += FrameMs;
+	MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+	TotalGameThreadMs += GameThreadMs;
+
+	if (Time - FramesStartTime >= 1.f)
+	{
+		FGeoTelemetryEvent Event;
+		Event.Type = EGeoTelemetryEvent::Frames;
+		Event.Time = Time;
+		Event.Wave = CurrentWave;
+		Event.Value[0] = (float)NumFrames;
+		Event.Value[1] = TotalFrameMs / NumFrames;
+		Event.Value[2] = MaxFrameMs;
+		Event.Value[3] = TotalGameThreadMs / NumFrames;
+		Queue.Enqueue(Event);
+
+		NumFrames = 0;
+	}
+}
+
+uint32 FGeoTelemetry::Run()
+{
+	while (!bStopping)
+	{
+		Drain();
+
+		if (Buffers[ActiveBuffer].Num() >= FlushSize || FPlatformTime::Seconds() - LastFlushTime >= 1.0)
+		{
+			Flush();
+		}
+
+		WakeEvent->Wait(FMath::Max(1, (int32)(DrainInterval * 1000.f)));
+	}
+
+	/** the game thread doesn't push anymore  */
+	Drain();
+	Flush();
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+	return 0;
+}
+
+void FGeoTelemetry::Stop()
+{
+	bStopping = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FGeoTelemetry::Drain()
+{
+	TArray<uint8>& Buffer = Buffers[ActiveBuffer];
+
+	FGeoTelemetryEvent Event;
+	while (Queue.Dequeue(Event))
+	{
+		const FString Line = Event.ToJson() + TEXT("\n");
+		FTCHARToUTF8 Utf8(*Line);
+		Buffer.Append((const uint8*)Utf8.Get(), Utf8.Length());
+	}
+}
+
+void FGeoTelemetry::Flush()
+{
+	LastFlushTime = FPlatformTime::Seconds();
+	if (Buffers[ActiveBuffer].Num() == 0) { return; }
+
+	/** the other buffer is free once its write is done  */
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
+	TArray<uint8>* Full = &Buffers[ActiveBuffer];
+	ActiveBuffer = 1 - ActiveBuffer;
+	Buffers[ActiveBuffer].Reset();
+
+	FArchive* File = FileWriter.Get();
+	PendingWrite = Async<void>(EAsyncExecution::ThreadPool, [File, Full]()
+	{
+		File->Serialize(Full->GetData(), Full->Num());
+		File->Flush();
+	});
+}
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "Async/Future.h"
+
+enum class EGeoTelemetryEvent : uint8
+{
+	MatchStart,
+	MatchEnd,
+	WaveStart,		/** Value0 - enemies of the wave  */
+	WaveEnd,		/** Value0 - wave duration in sec  */
+	EnemySpawned,	/** Name - enemy class  */
+	EnemyKilled,	/** Name - enemy class, Player - the killer  */
+	PlayerKills,	/** Player, Value0 - enemies killed by the player so far  */
+	GeoDamaged,		/** Player, Value0 - damage, Value1 - health left  */
+	Frames,			/** Value0 - frames, Value1 - avg frame ms, Value2 - max frame ms, Value3 - avg game thread ms */
+	SpawnDirector,	/** Value0 - spawn interval in sec, Value1 - alive cap (0 - none), Value2 - avg game thread ms */
+};
+
+/** one record of the telemetry stream, small enough to be copied through the queue */
+struct FGeoTelemetryEvent
+{
+	EGeoTelemetryEvent Type = EGeoTelemetryEvent::MatchStart;
+
+	/** world time in seconds  */
+	float Time = 0.f;
+
+	int32 Wave = 0;
+
+	/** PlayerId, INDEX_NONE if the event has no player  */
+	int32 Player = INDEX_NONE;
+
+	FName Name;
+
+	float Value[4] = {};
+
+	/** returns the name of the event in the stream  */
+	static const TCHAR* GetTypeName(EGeoTelemetryEvent Type);
+
+	/** returns one JSON line without the line terminator  */
+	FString ToJson() const;
+};
+
+/**
+*	append-only JSON-lines telemetry of one match ( Saved/Telemetry/<Map>-<time>.jsonl ).
+*	The game thread only pushes events into a lock-free single producer queue,
+*	the writer thread formats them into one of two buffers while the other one is written to disk.
+*	GeoTelemetry commandlet turns the stream into per-wave summary tables
+*/
+class SILLYGEO_API FGeoTelemetry : public FRunnable
+{
+public:
+
+	~FGeoTelemetry();
+
+	/** creates the file and starts the writer thread  */
+	bool Open(const FString& Path, const UWorld* InWorld);
+
+	/** writes everything pushed so far and stops the writer thread */
+	void Close();
+
+	/** [game thread] sets the wave stamped on next events  */
+	void SetWave(int32 Wave) { CurrentWave = Wave; }
+
+	/** [game thread] stamps the event with world time and the current wave and queues it */
+	void Push(EGeoTelemetryEvent Type, int32 Player = INDEX_NONE, FName Name = NAME_None, float Value0 = 0.f, float Value1 = 0.f, float Value2 = 0.f);
+
+	/** [game thread] adds the frame to the summary, pushes the summary once a second */
+	void AddFrame(float FrameMs, float GameThreadMs);
+
+	/** FRunnable  */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	/** how often (in sec) the writer thread wakes up to drain the queue  */
+	float DrainInterval = 0.1f;
+
+	/** a buffer is written when it grows over this size (in bytes) or once a second */
+	int32 FlushSize = 64 * 1024;
+
+private:
+
+	/** [writer thread] formats all queued events into the active buffer */
+	void Drain();
+
+	/** [writer thread] swaps the buffers and writes the full one on the thread pool */
+	void Flush();
+
+	/** single producer (game thread), single consumer (writer thread)  */
+	TQueue<FGeoTelemetryEvent, EQueueMode::Spsc> Queue;
+
+	/** [writer thread] the active buffer is filled, the other one is being written */
+	TArray<uint8> Buffers[2];
+	int32 ActiveBuffer = 0;
+	double LastFlushTime = 0.0;
+	TFuture<void> PendingWrite;
+
+	TUniquePtr<FArchive> FileWriter;
+	class FRunnableThread* Thread = nullptr;
+	class FEvent* WakeEvent = nullptr;
+	FThreadSafeBool bStopping;
+
+	/** [game thread] event stamps  */
+	const UWorld* World = nullptr;
+	int32 CurrentWave = 0;
+
+	/** [game thread] frames of the current second  */
+	float FramesStartTime = 0.f;
+	int32 NumFrames = 0;
+	float TotalFrameMs = 0.f;
+	float MaxFrameMs = 0.f;
+	float TotalGameThreadMs = 0.f;
+};
@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoTelemetryCommandlet.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace GeoTelemetry
+{
+	/** everything the stream tells about one wave  */
+	struct FWaveSummary
+	{
+		int32 Enemies = 0;
+		float StartTime = 0.f;
+		float Duration = 0.f;
+		int32 Spawned = 0;
+		int32 Killed = 0;
+		float DamageTaken = 0.f;
+		int32 GeoHits = 0;
+
+		/** frame summaries  */
+		int32 Frames = 0;
+		double TotalFrameMs = 0.0;
+		double TotalGameThreadMs = 0.0;
+		float MaxFrameMs = 0.f;
+
+		/** the slowest second of the wave  */
+		float WorstSecondAvgMs = 0.f;
+
+		/** spawn director decisions, the longest interval and the tightest cap */
+		int32 DirectorDecisions = 0;
+		float MaxSpawnInterval = 0.f;
+		int32 MinAliveCap = 0;
+
+		/** player id -> kills / damage taken during the wave  */
+		TMap<int32, int32> PlayerKills;
+		TMap<int32, float> PlayerDamage;
+	};
+}
+
+UGeoTelemetryCommandlet::UGeoTelemetryCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGeoTelemetryCommandlet::Main(const FString& Params)
+{
+	using namespace GeoTelemetry;
+
+	FString Path;
+	if (!FParse::Value(*Params, TEXT("File="), Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: -run=GeoTelemetry -File=<stream>.jsonl"));
+		return 1;
+	}
+	if (FPaths::IsRelative(Path))
+	{
+		Path = FPaths::Combine(FPaths::ProjectDir(), Path);
+	}
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to read telemetry %s"), *Path);
+		return 1;
+	}
+
+	TMap<int32, FWaveSummary> Waves;
+	TSet<int32> Players;
+	int32 BadLines = 0;
+
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty()) { continue; }
+
+		TSharedPtr<FJsonObject> Event;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Line), Event) || !Event.IsValid())
+		{
+			/** the last line is cut if the game crashed  */
+			BadLines++;
+			continue;
+		}
+
+		const FString Type = Event->GetStringField(TEXT("e"));
+		const float Time = (float)Event->GetNumberField(TEXT("t"));
+		const int32 Player = Event->HasField(TEXT("player")) ? (int32)Event->GetNumberField(TEXT("player")) : INDEX_NONE;
+		FWaveSummary& Wave = Waves.FindOrAdd((int32)Event->GetNumberField(TEXT("wave")));
+
+		if (Type == TEXT("WaveStart"))
+		{
+			Wave.Enemies = (int32)Event->GetNumberField(TEXT("enemies"));
+			Wave.StartTime = Time;
+		}
+		else if (Type == TEXT("WaveEnd"))
+		{
+			Wave.Duration = (float)Event->GetNumberField(TEXT("duration"));
+		}
+		else if (Type == TEXT("EnemySpawned"))
+		{
+			Wave.Spawned++;
+		}
+		else if (Type == TEXT("EnemyKilled"))
+		{
+			Wave.Killed++;
+			if (Player != INDEX_NONE)
+			{
+				Wave.PlayerKills.FindOrAdd(Player)++;
+				Players.Add(Player);
+			}
+		}
+		else if (Type == TEXT("GeoDamaged"))
+		{
+			const float Damage = (float)Event->GetNumberField(TEXT("damage"));
+			Wave.DamageTaken += Damage;
+			Wave.GeoHits++;
+			if (Player != INDEX_NONE)
+			{
+				Wave.PlayerDamage.FindOrAdd(Player) += Damage;
+				Players.Add(Player);
+			}
+		}
+		else if (Type == TEXT("Frames"))
+		{
+			const int32 Frames = (int32)Event->GetNumberField(TEXT("frames"));
+			const float AvgMs = (float)Event->GetNumberField(TEXT("avg_ms"));
+			Wave.Frames += Frames;
+			Wave.TotalFrameMs += AvgMs * Frames;
+			Wave.TotalGameThreadMs += Event->GetNumberField(TEXT("gt_ms")) * Frames;
+			Wave.MaxFrameMs = FMath::Max(Wave.MaxFrameMs, (float)Event->GetNumberField(TEXT("max_ms")));
+			Wave.WorstSecondAvgMs = FMath::Max(Wave.WorstSecondAvgMs, AvgMs);
+		}
+		else if (Type == TEXT("SpawnDirector"))
+		{
+			const int32 AliveCap = (int32)Event->GetNumberField(TEXT("alive_cap"));
+			Wave.DirectorDecisions++;
+			Wave.MaxSpawnInterval = FMath::Max(Wave.MaxSpawnInterval, (float)Event->GetNumberField(TEXT("interval")));
+			if (AliveCap > 0)
+			{
+				Wave.MinAliveCap = Wave.MinAliveCap > 0 ? FMath::Min(Wave.MinAliveCap, AliveCap) : AliveCap;
+			}
+		}
+	}
+
+	Waves.KeySort(TLess<int32>());
+	TArray<int32> SortedPlayers = Players.Array();
+	SortedPlayers.Sort();
+
+	/** wave 0 is the time before the first wave  */
+	FString WavesCsv = TEXT("Wave,Enemies,Duration,Spawned,Killed,KillsPerSec,GeoHits,DamageTaken,Frames,AvgFrameMs,MaxFrameMs,WorstSecondMs,AvgGameThreadMs,DirectorDecisions,MaxSpawnInterval,MinAliveCap") LINE_TERMINATOR;
+	UE_LOG(LogTemp, Display, TEXT("%s"), TEXT(" Wave | Enemies | Duration | Spawned | Killed | Kills/s | Hits | Damage | Avg ms | Max ms | Worst 1s ms | GT ms | Spawn interval | Alive cap"));
+	for (const TPair<int32, FWaveSummary>& Pair : Waves)
+	{
+		const FWaveSummary& Wave = Pair.Value;
+		const float KillsPerSec = Wave.Duration > 0.f ? Wave.Killed / Wave.Duration : 0.f;
+		const float AvgFrameMs = Wave.Frames > 0 ? (float)(Wave.TotalFrameMs / Wave.Frames) : 0.f;
+		const float AvgGameThreadMs = Wave.Frames > 0 ? (float)(Wave.TotalGameThreadMs / Wave.Frames) : 0.f;
+
+		WavesCsv += FString::Printf(TEXT("%d,%d,%.2f,%d,%d,%.2f,%d,%.1f,%d,%.2f,%.2f,%.2f,%.2f,%d,%.3f,%d") LINE_TERMINATOR,
+			Pair.Key, Wave.Enemies, Wave.Duration, Wave.Spawned, Wave.Killed, KillsPerSec, Wave.GeoHits, Wave.DamageTaken,
+			Wave.Frames, AvgFrameMs, Wave.MaxFrameMs, Wave.WorstSecondAvgMs, AvgGameThreadMs,
+			Wave.DirectorDecisions, Wave.MaxSpawnInterval, Wave.MinAliveCap);
+
+		UE_LOG(LogTemp, Display, TEXT(" %4d | %7d | %8.1f | %7d | %6d | %7.2f | %4d | %6.0f | %6.2f | %6.2f | %11.2f | %5.2f | %14.2f | %9d"),
+			Pair.Key, Wave.Enemies, Wave.Duration, Wave.Spawned, Wave.Killed, KillsPerSec, Wave.GeoHits, Wave.DamageTaken,
+			AvgFrameMs, Wave.MaxFrameMs, Wave.WorstSecondAvgMs, AvgGameThreadMs, Wave.MaxSpawnInterval, Wave.MinAliveCap);
+	}
+
+	/** one row per wave and player  */
+	FString PlayersCsv = TEXT("Wave,Player,Kills,DamageTaken") LINE_TERMINATOR;
+	for (const TPair<int32, FWaveSummary>& Pair : Waves)
+	{
+		for (const int32 Player : SortedPlayers)
+		{
+			const int32* Kills = Pair.Value.PlayerKills.Find(Player);
+			const float* Damage = Pair.Value.PlayerDamage.Find(Player);
+			if (Kills || Damage)
+			{
+				PlayersCsv += FString::Printf(TEXT("%d,%d,%d,%.1f") LINE_TERMINATOR, Pair.Key, Player, Kills ? *Kills : 0, Damage ? *Damage : 0.f);
+			}
+		}
+	}
+
+	const FString BasePath = FPaths::GetPath(Path) / FPaths::GetBaseFilename(Path);
+	const bool bWaves = FFileHelper::SaveStringToFile(WavesCsv, *(BasePath + TEXT(".waves.csv")));
+	const bool bPlayers = FFileHelper::SaveStringToFile(PlayersCsv, *(BasePath + TEXT(".players.csv")));
+
+	UE_LOG(LogTemp, Display, TEXT("%d events, %d waves, %d players, %d unreadable lines -> %s.waves.csv, %s.players.csv"),
+		Lines.Num() - BadLines, Waves.Num(), SortedPlayers.Num(), BadLines, *BasePath, *BasePath);
+
+	return bWaves && bPlayers ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GeoTelemetryCommandlet.generated.h"
+
+/**
+*	turns a telemetry stream into per-wave summary tables:
+*	UE4Editor-Cmd SillyGeo -run=GeoTelemetry -File=Saved/Telemetry/<Map>-<time>.jsonl
+*	logs the tables and writes them next to the stream as <name>.waves.csv and <name>.players.csv
+*/
+UCLASS()
+class UGeoTelemetryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UGeoTelemetryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeoWaveDataAsset.h"
+#include "SillyGeo.h"
+#include "EnemyBase.h"
+
+const FPrimaryAssetType UGeoWaveDataAsset::WaveAssetType = TEXT("GeoWave");
+
+void UGeoWaveDataAsset::GetEnemyClasses(TArray<FSoftObjectPath>& OutClasses) const
+{
+	for (const FGeoWaveEnemy& Enemy : Enemies)
+	{
+		if (!Enemy.EnemyTemplate.IsNull())
+		{
+			OutClasses.AddUnique(Enemy.EnemyTemplate.ToSoftObjectPath());
+		}
+	}
+}
+
+void UGeoWaveDataAsset::GetWaveInfo(FWaveInfo& OutWaveInfo) const
+{
+	OutWaveInfo.SpawnInfo.Reset();
+	OutWaveInfo.MaxEnemiesThisWave = 0;
+	for (const FGeoWaveEnemy& Enemy : Enemies)
+	{
+		FSpawnInfo& SpawnInfo = OutWaveInfo.SpawnInfo[OutWaveInfo.SpawnInfo.AddDefaulted()];
+		SpawnInfo.EnemyTemplate = Enemy.EnemyTemplate.Get();
+		SpawnInfo.MaxEnemiesAmount = Enemy.MaxEnemiesAmount;
+		OutWaveInfo.MaxEnemiesThisWave += Enemy.MaxEnemiesAmount;
+	}
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GeoWaveDataAsset.generated.h"
+
+/** enemy type of a wave and how many of them the wave spawns */
+USTRUCT(BlueprintType)
+struct FGeoWaveEnemy
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** enemy template class, streamed in only for the current and the next wave */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AAA")
+	TSoftClassPtr<class AEnemyBase> EnemyTemplate;
+
+	/** how many enemies of this type will be spawned during the wave  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AAA")
+	int32 MaxEnemiesAmount = 10;
+};
+
+/**
+*	one wave of the wave table as a primary data asset ( /Game/Waves ).
+*	The asset itself is tiny and loads with the map, enemy classes it names
+*	are streamed in by the game mode during the rest before the wave
+*/
+UCLASS(BlueprintType)
+class SILLYGEO_API UGeoWaveDataAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** primary asset type of all waves  */
+	static const FPrimaryAssetType WaveAssetType;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override { return FPrimaryAssetId(WaveAssetType, GetFName()); }
+
+	/** adds enemy classes of this wave to stream in  */
+	void GetEnemyClasses(TArray<FSoftObjectPath>& OutClasses) const;
+
+	/** fills the wave info, enemy templates are set only if their classes are loaded */
+	void GetWaveInfo(struct FWaveInfo& OutWaveInfo) const;
+
+	/** enemy types of this wave  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AAA")
+	TArray<FGeoWaveEnemy> Enemies;
+};
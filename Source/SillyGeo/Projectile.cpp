@@ -5,11 +5,16 @@
 #include "Particles/ParticleSystemComponent.h"
 #include "Components/PointLightComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
-#include "ConstructorHelpers.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
 #include "Geo.h"
-#include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "EnemyBase.h"
+#include "SillyGeo.h"
+#include "SillyGeoStats.h"
+#include "GeoGameState.h"
+#include "TimerManager.h"
+#include "SillyGeoGameMode.h"
 
 // Sets default values
 AProjectile::AProjectile()
@@ -23,17 +28,20 @@ AProjectile::AProjectile()
 	SphereCollision->SetSphereRadius(8.f);
 	SphereCollision->SetCollisionProfileName("ProjectileBase");
 
+	/** cosmetic components, created everywhere so blueprints match the class,
+	*	a dedicated server destroys them in PostInitializeComponents
+	*/
+
 	/** projectile trail  */
 	ProjectileTrail = CreateDefaultSubobject<UParticleSystemComponent>(TEXT("ProjectileTrail"));
 	ProjectileTrail->SetupAttachment(RootComponent);
-	
-	/** set emitter template  */
-	static ConstructorHelpers::FObjectFinder<UParticleSystem> ParticleSystem(TEXT("/Game/Weapons/Particles/PFX_Param_Projectile"));
-	if (ParticleSystem.Object)
+
+	/** set emitter template, a dedicated server never loads it  */
+	if (!ShouldStripCosmetics())
 	{
-		ProjectileTrail->SetTemplate(ParticleSystem.Object);
+		TrailTemplateAsset = FSoftObjectPath(TEXT("/Game/Weapons/Particles/PFX_Param_Projectile.PFX_Param_Projectile"));
 	}
-	
+
 	/** projectile light  */
 	ProjectileLight = CreateDefaultSubobject<UPointLightComponent>(TEXT("ProjectileLight"));
 	ProjectileLight->SetupAttachment(RootComponent);
@@ -49,18 +57,67 @@ AProjectile::AProjectile()
 	ProjectileMovementComponent->bConstrainToPlane = true;
 	ProjectileMovementComponent->ProjectileGravityScale = 0.f;
 
-	/** set explosion sound  */
-	static ConstructorHelpers::FObjectFinder<USoundBase> ExplosionSoundTemplate(TEXT("/Game/Player/Audio/FlashImpact_Cue"));
-	if (ExplosionSoundTemplate.Succeeded())
+	/** class defaults  */
+	bDealsDamage = true;
+	bHoming = false;
+	bExplosive = false;
+
+	if (!ShouldStripCosmetics())
+	{
+		/** set explosion sound and emitter template, soft references are streamed in with the map */
+		ExplosionSoundAsset = FSoftObjectPath(TEXT("/Game/Player/Audio/FlashImpact_Cue.FlashImpact_Cue"));
+		ExplosionEmitterAsset = FSoftObjectPath(TEXT("/Game/Weapons/Particles/PFX_Param_Explosion.PFX_Param_Explosion"));
+	}
+}
+
+void AProjectile::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (ShouldStripCosmetics())
+	{
+		StripCosmeticComponent(ProjectileTrail);
+		StripCosmeticComponent(ProjectileLight);
+	}
+}
+
+void AProjectile::OnConstruction(const FTransform& Transform)
+{
+	/** loaded already if the game mode has preloaded them, otherwise loaded right now,
+	*	all of them are cosmetic, so never on dedicated server
+	*/
+	if (ShouldStripCosmetics())
+	{
+		Super::OnConstruction(Transform);
+		return;
+	}
+
+	if (ProjectileTrail && !ProjectileTrail->Template)
+	{
+		ProjectileTrail->SetTemplate(TrailTemplateAsset.LoadSynchronous());
+	}
+	if (!ExplosionSound)
+	{
+		ExplosionSound = ExplosionSoundAsset.LoadSynchronous();
+	}
+	if (!ExplosionEmitter)
 	{
-		ExplosionSound = ExplosionSoundTemplate.Object;
+		ExplosionEmitter = ExplosionEmitterAsset.LoadSynchronous();
 	}
 
-	/** set explosion emitter template  */
-	static ConstructorHelpers::FObjectFinder<UParticleSystem> ExplosionEmitterTemplate(TEXT("/Game/Weapons/Particles/PFX_Param_Explosion"));
-	if (ExplosionEmitterTemplate.Succeeded())
+	Super::OnConstruction(Transform);
+}
+
+void AProjectile::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (ShouldStripCosmetics()) { return; }
+
+	for (const FSoftObjectPath& Asset : { TrailTemplateAsset.ToSoftObjectPath(), ExplosionSoundAsset.ToSoftObjectPath(), ExplosionEmitterAsset.ToSoftObjectPath() })
 	{
-		ExplosionEmitter = ExplosionEmitterTemplate.Object;
+		if (Asset.IsValid())
+		{
+			OutAssets.AddUnique(Asset);
+		}
 	}
 }
 
@@ -68,26 +125,107 @@ AProjectile::AProjectile()
 void AProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+
+	INC_DWORD_STAT(STAT_LiveProjectiles);
+	FSillyGeoFrameEvents::LiveProjectiles++;
 	
 	SphereCollision->OnComponentBeginOverlap.AddDynamic(this, &AProjectile::OnOverlapBegin);
 
-	/** set color for trail and projectile light, add inherited velocity from owner  */
-	if(AGeo* Geo = Cast<AGeo>(GetOwner()))
+	/** set velocity, add inherited velocity from owner  */
+	FVector NewVelocity = ProjectileMovementComponent->Velocity + FVector(InheritedSpeed, 0.f, 0.f);
+	ProjectileMovementComponent->SetVelocityInLocalSpace(NewVelocity);
+
+	/** the weapon type comes from the shooter, so restored and remote shots get it too */
+	const AGeo* Shooter = Cast<AGeo>(GetOwner());
+	const EGeoWeaponType WeaponType = Shooter ? Shooter->GetWeaponType(Weapon) : EGeoWeaponType::Standard;
+	bExplosive = WeaponType == EGeoWeaponType::Explosive;
+
+	/** shots of homing weapon steer to enemies of their color, as fast as they were fired */
+	EEnemyColor HomingColor;
+	if (WeaponType == EGeoWeaponType::Homing && AEnemyBase::FindColorType(ProjectileColor, HomingColor))
 	{
-		/** set velocity  */
-		FVector OwnerVelocity = FVector(FMath::Abs(Geo->GetCharacterMovement()->Velocity.X), 0.f, 0.f);
-		FVector NewVelocity = ProjectileMovementComponent->Velocity + OwnerVelocity;
-		ProjectileMovementComponent->SetVelocityInLocalSpace(NewVelocity);
+		bHoming = true;
+		HomingColorMask = FGeoEnemySpatialIndex::ColorBit(HomingColor);
+		ProjectileMovementComponent->HomingAccelerationMagnitude = HomingAcceleration;
+		ProjectileMovementComponent->MaxSpeed = ProjectileMovementComponent->Velocity.Size();
+		SetLifeSpan(HomingLifeSpan);
 
-		/** set color for projectile trail and for projectile light */
-		ProjectileColor = Geo->GetCurrentWeaponColor();
+		Retarget();
+		GetWorldTimerManager().SetTimer(RetargetTimer, this, &AProjectile::Retarget, HomingRetargetInterval, true);
+	}
+
+	/** set color for projectile trail and for projectile light */
+	if (ProjectileLight)
+	{
 		ProjectileLight->SetLightColor(ProjectileColor);
+	}
+	if (ProjectileTrail)
+	{
 		ProjectileTrail->SetColorParameter("ProjectileColor", ProjectileColor);
 	}
+
+	if (const AGeoGameState* GeoGameState = GetWorld()->GetGameState<AGeoGameState>())
+	{
+		if (const FGeoQualitySettings* Quality = GeoGameState->GetQualitySettings())
+		{
+			ApplyQualitySettings(*Quality);
+		}
+	}
+}
+
+void AProjectile::ApplyQualitySettings(const FGeoQualitySettings& Settings)
+{
+	if (ProjectileTrail)
+	{
+		ProjectileTrail->SetFloatParameter("SpawnRateScale", Settings.ProjectileTrailSpawnScale);
+	}
+	if (ProjectileLight)
+	{
+		ProjectileLight->SetVisibility(Settings.bProjectileLights);
+	}
+}
+
+void AProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT(STAT_LiveProjectiles);
+	FSillyGeoFrameEvents::LiveProjectiles--;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AProjectile::InitProjectile(int32 NewWeapon, const FLinearColor& NewColor, float NewInheritedSpeed, bool bNewDealsDamage)
+{
+	Weapon = NewWeapon;
+	ProjectileColor = NewColor;
+	InheritedSpeed = NewInheritedSpeed;
+	bDealsDamage = bNewDealsDamage;
+}
+
+void AProjectile::Retarget()
+{
+	const AGeoGameState* GeoGameState = GetWorld()->GetGameState<AGeoGameState>();
+	AEnemyBase* Target = GeoGameState ? GeoGameState->GetEnemyIndex().FindNearest(GetActorLocation(), HomingRadius, HomingColorMask) : nullptr;
+
+	/** no enemy around, fly straight on  */
+	ProjectileMovementComponent->HomingTargetComponent = Target ? Target->GetRootComponent() : nullptr;
+	ProjectileMovementComponent->bIsHomingProjectile = Target != nullptr;
+}
+
+float AProjectile::GetCollisionRadius() const
+{
+	return SphereCollision->GetScaledSphereRadius();
+}
+
+void AProjectile::FastForward(float Time)
+{
+	/** sweep, so we still hit whatever is on the way  */
+	SetActorLocation(GetActorLocation() + ProjectileMovementComponent->Velocity * Time, true);
 }
 
 void AProjectile::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult & SweepResult)
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_ProjectileOverlap, ProjectileOverlap);
+
 	// Other Actor is the actor that triggered the event. Check that is not ourself. 
 	if ((OtherActor != nullptr) && (OtherActor != this) && (OtherComp != nullptr) && !OtherActor->IsPendingKill())
 	{
@@ -100,14 +238,35 @@ void AProjectile::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActo
 			/** and color are same */
 			if (Enemy->GetEnemyColor() == ProjectileColor)
 			{
-				AController* InstigatorController = nullptr;
-				if (GetOwner())
+				if (bDealsDamage)
 				{
-					InstigatorController = GetOwner()->GetInstigatorController();
-				}
+					AController* InstigatorController = nullptr;
+					if (GetOwner())
+					{
+						InstigatorController = GetOwner()->GetInstigatorController();
+					}
 
-				/** inflict damage to this enemy  */
-				Enemy->TakeDamage(DamageToCause, FDamageEvent(), InstigatorController, this);
+					ASillyGeoGameMode* GameMode = GetWorld()->GetAuthGameMode<ASillyGeoGameMode>();
+					if (bExplosive && GameMode)
+					{
+						/** damage every enemy of our color around, the hit one included  */
+						GameMode->ResolveBlast(Enemy->GetActorLocation(), BlastRadius, BlastDamage, Enemy->GetColorType(), InstigatorController);
+					}
+					else
+					{
+						/** inflict damage to this enemy  */
+						Enemy->TakeDamage(DamageToCause, FDamageEvent(), InstigatorController, this);
+					}
+				}
+				else
+				{
+					/** our own shot hit a replicated enemy, let the server validate the hit  */
+					AGeo* Geo = Cast<AGeo>(GetOwner());
+					if (Geo && Geo->IsLocallyControlled() && Enemy->IsNetProxy())
+					{
+						Geo->ReportHit(Enemy, GetActorLocation(), ShotId);
+					}
+				}
 			}
 		}
 		
@@ -117,10 +276,17 @@ void AProjectile::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActo
 
 void AProjectile::SpawnExplosionFX()
 {
-	/** spawn explosion FX  */
-	if (ExplosionEmitter)
+	if (ShouldStripCosmetics())
+	{
+		return;
+	}
+
+	/** spawn explosion FX, if the quality tier has the budget for it */
+	AGeoGameState* GeoGameState = GetWorld()->GetGameState<AGeoGameState>();
+	const FVector SpawnLocation = SphereCollision->GetComponentLocation();
+	if (ExplosionEmitter && (!GeoGameState || GeoGameState->ConsumeExplosionFX(SpawnLocation)))
 	{
-		FVector SpawnLocation = SphereCollision->GetComponentLocation();
+		SILLYGEO_LLM_SCOPE(FX);
 		FRotator SpawnRotation = FRotator(0.f, 0.f, 0.f);
 		UParticleSystemComponent* ExplosionFX = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEmitter, SpawnLocation, SpawnRotation);
 		if (ExplosionFX)
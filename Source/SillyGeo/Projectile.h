@@ -35,13 +35,72 @@ class SILLYGEO_API AProjectile : public AActor
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	class UParticleSystem* ExplosionEmitter;
 
+	/** trail and explosion FX, all cosmetic, never loaded on dedicated server  */
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UParticleSystem> TrailTemplateAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class USoundBase> ExplosionSoundAsset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config|Assets", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<class UParticleSystem> ExplosionEmitterAsset;
+
+public:
+
+	/** calls before FinishSpawning to set up the shot
+	*	@param bNewDealsDamage - false for cosmetic projectiles simulated on clients
+	*/
+	void InitProjectile(int32 NewWeapon, const FLinearColor& NewColor, float NewInheritedSpeed, bool bNewDealsDamage);
+
+	/** calls to move the projectile along its path by specified time  */
+	void FastForward(float Time);
+
+	/** returns the radius of projectile collision  */
+	float GetCollisionRadius() const;
+
+	/** returns the damage this projectile causes  */
+	FORCEINLINE float GetDamageToCause() const { return DamageToCause; }
+
+	/** returns the radius (in uu) of the blast of explosive weapon  */
+	FORCEINLINE float GetBlastRadius() const { return BlastRadius; }
+
+	/** returns the damage of the blast of explosive weapon  */
+	FORCEINLINE float GetBlastDamage() const { return BlastDamage; }
+
+	/** sets the number the shooter confirms the hit of this shot with  */
+	FORCEINLINE void SetShotId(uint8 NewShotId) { ShotId = NewShotId; }
+
+	/** returns the number of owner weapon this projectile was fired from  */
+	FORCEINLINE int32 GetWeapon() const { return Weapon; }
+
+	/** returns projectile color  */
+	FORCEINLINE FLinearColor GetProjectileColor() const { return ProjectileColor; }
+
+	/** returns owner speed added to the projectile speed  */
+	FORCEINLINE float GetInheritedSpeed() const { return InheritedSpeed; }
+
+	/** adds default assets of this projectile to preload  */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** scales trail spawn rate and turns the light on / off according to the quality tier */
+	void ApplyQualitySettings(const struct FGeoQualitySettings& Settings);
+
 protected:
 
 	// Sets default values for this actor's properties
 	AProjectile();
+
+	/** fills empty components and properties with default assets  */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	/** destroys cosmetic components on a dedicated server  */
+	virtual void PostInitializeComponents() override;
 	
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	/** updates live projectiles stat  */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	/** calls when sphere overlaps other actor  */
 	UFUNCTION()
@@ -53,6 +112,9 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void SpawnExplosionFX();
 
+	/** [homing] steers to the nearest enemy of the projectile color, found through the enemy index of the game state */
+	void Retarget();
+
 	/** color to apply to projectile light,
 	*	projectile trail and projectile explosion FX
 	*	depends on owner current weapon (Current Color)
@@ -63,5 +125,57 @@ private:
 	/** damage to cause to victim  */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	float DamageToCause = 50.f;
+
+	/** the number of owner weapon this projectile was fired from  */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	int32 Weapon = 0;
+
+	/** owner speed added to the projectile speed  */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float InheritedSpeed = 0.f;
+
+	/** shows whether this projectile hurts enemies or it is just a cosmetic copy of the server one */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	uint32 bDealsDamage : 1;
+
+	/** shows whether this projectile was fired from a homing weapon  */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Homing", meta = (AllowPrivateAccess = "true"))
+	uint32 bHoming : 1;
+
+	/** [homing] how fast (in uu/sec^2) the projectile turns to its target  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Homing", meta = (AllowPrivateAccess = "true"))
+	float HomingAcceleration = 8000.f;
+
+	/** [homing] enemies farther than this (in uu) aren't targeted  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Homing", meta = (AllowPrivateAccess = "true"))
+	float HomingRadius = 3000.f;
+
+	/** [homing] how often (in sec) the nearest enemy is looked up again  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Homing", meta = (AllowPrivateAccess = "true"))
+	float HomingRetargetInterval = 0.2f;
+
+	/** [homing] life span (in sec), so a shot that misses doesn't circle forever */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Homing", meta = (AllowPrivateAccess = "true"))
+	float HomingLifeSpan = 4.f;
+
+	/** shows whether this projectile was fired from an explosive weapon  */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Blast", meta = (AllowPrivateAccess = "true"))
+	uint32 bExplosive : 1;
+
+	/** [explosive] enemies of the projectile color within this radius (in uu) from the impact are damaged */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blast", meta = (AllowPrivateAccess = "true"))
+	float BlastRadius = 600.f;
+
+	/** [explosive] damage to cause to every enemy of the blast  */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blast", meta = (AllowPrivateAccess = "true"))
+	float BlastDamage = 50.f;
+
+	/** the number of the shot for hit confirmation, 0 - the hit isn't reported  */
+	uint8 ShotId = 0;
+
+	/** [homing] enemy index color mask of the projectile color  */
+	uint8 HomingColorMask = 0;
+
+	FTimerHandle RetargetTimer;
 	
 };
@@ -1,6 +1,146 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "SillyGeo.h"
+#include "SillyGeoStats.h"
 #include "Modules/ModuleManager.h"
+#include "Misc/CoreDelegates.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, SillyGeo, "SillyGeo" );
+class FSillyGeoModule : public FDefaultGameModuleImpl
+{
+public:
+
+	virtual void StartupModule() override
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		RegisterSillyGeoLLMTags();
+#endif
+
+		/** per-frame counters are latched in one place, so every reader sees the same frame */
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FSillyGeoModule::EndFrame);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	}
+
+private:
+
+	static void EndFrame()
+	{
+#if SILLYGEO_FRAME_COUNTERS
+		FSillyGeoFrameCounters::EndFrame();
+#endif
+		FSillyGeoFrameEvents::EndFrame();
+	}
+
+	FDelegateHandle EndFrameHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FSillyGeoModule, SillyGeo, "SillyGeo" );
+
+DEFINE_STAT(STAT_ReplicatedEnemies);
+DEFINE_STAT(STAT_DirtyEnemyEntries);
+DEFINE_STAT(STAT_EnemyBytesPerEnemySecond);
+DEFINE_STAT(STAT_ValidateHit);
+DEFINE_STAT(STAT_RejectedHits);
+DEFINE_STAT(STAT_SkippedRepCompares);
+DEFINE_STAT(STAT_EnemyBytesPerConnectionSecond);
+DEFINE_STAT(STAT_RelevantEnemies);
+DEFINE_STAT(STAT_InterestUpdate);
+
+DEFINE_STAT(STAT_GeoFire);
+DEFINE_STAT(STAT_GeoRotateToMouseCursor);
+DEFINE_STAT(STAT_EnemyTracking);
+DEFINE_STAT(STAT_EnemyFollow);
+DEFINE_STAT(STAT_EnemyTakeDamage);
+DEFINE_STAT(STAT_ProjectileOverlap);
+DEFINE_STAT(STAT_GameModeSpawnEnemy);
+DEFINE_STAT(STAT_GameModeUpdateHUD);
+DEFINE_STAT(STAT_GameModeResolveBlast);
+DEFINE_STAT(STAT_SpawnerSpawnEnemy);
+DEFINE_STAT(STAT_LiveEnemies);
+DEFINE_STAT(STAT_LiveProjectiles);
+DEFINE_STAT(STAT_LiveEmitters);
+DEFINE_STAT(STAT_SpawnDirectorInterval);
+DEFINE_STAT(STAT_SpawnDirectorAliveCap);
+DEFINE_STAT(STAT_SpawnDirectorGameThreadMs);
+DEFINE_STAT(STAT_SpawnDirectorHeldSpawns);
+DEFINE_STAT(STAT_SplitScreenViewGroups);
+DEFINE_STAT(STAT_SplitScreenLowSignificance);
+DEFINE_STAT(STAT_SplitScreenSignificance);
+DEFINE_STAT(STAT_IndexedEnemies);
+DEFINE_STAT(STAT_EnemyIndexUpdate);
+DEFINE_STAT(STAT_EnemyIndexQuery);
+DEFINE_STAT(STAT_BlastKills);
+
+#if SILLYGEO_FRAME_COUNTERS
+
+uint64 FSillyGeoFrameCounters::Cycles[FSillyGeoFrameCounters::Num] = {};
+
+const TCHAR* const FSillyGeoFrameCounters::Names[FSillyGeoFrameCounters::Num] =
+{
+	TEXT("GeoFire"),
+	TEXT("GeoRotateToMouseCursor"),
+	TEXT("EnemyTracking"),
+	TEXT("EnemyFollow"),
+	TEXT("EnemyTakeDamage"),
+	TEXT("ProjectileOverlap"),
+	TEXT("GameModeSpawnEnemy"),
+	TEXT("GameModeUpdateHUD"),
+	TEXT("GameModeResolveBlast"),
+	TEXT("SpawnerSpawnEnemy"),
+};
+
+float FSillyGeoFrameCounters::LastFrameMs[FSillyGeoFrameCounters::Num] = {};
+
+void FSillyGeoFrameCounters::EndFrame()
+{
+	for (int32 i = 0; i < Num; i++)
+	{
+		LastFrameMs[i] = (float)FPlatformTime::ToMilliseconds64(Cycles[i]);
+		Cycles[i] = 0;
+	}
+}
+
+#endif
+
+int32 FSillyGeoFrameEvents::Counts[FSillyGeoFrameEvents::Num] = {};
+int32 FSillyGeoFrameEvents::LastFrame[FSillyGeoFrameEvents::Num] = {};
+int32 FSillyGeoFrameEvents::LiveEnemies = 0;
+int32 FSillyGeoFrameEvents::LiveProjectiles = 0;
+
+const TCHAR* const FSillyGeoFrameEvents::Names[FSillyGeoFrameEvents::Num] =
+{
+	TEXT("EnemiesSpawned"),
+	TEXT("EnemiesKilled"),
+	TEXT("ProjectilesSpawned"),
+};
+
+void FSillyGeoFrameEvents::EndFrame()
+{
+	for (int32 i = 0; i < Num; i++)
+	{
+		LastFrame[i] = Counts[i];
+		Counts[i] = 0;
+	}
+}
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+DECLARE_LLM_MEMORY_STAT(TEXT("SillyGeo Enemies"), STAT_SillyGeoEnemiesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("SillyGeo Projectiles"), STAT_SillyGeoProjectilesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("SillyGeo FX"), STAT_SillyGeoFXLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("SillyGeo MIDs"), STAT_SillyGeoDynamicMaterialsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("SillyGeo"), STAT_SillyGeoSummaryLLM, STATGROUP_LLM);
+
+void RegisterSillyGeoLLMTags()
+{
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	Tracker.RegisterProjectTag((int32)ESillyGeoLLMTag::Enemies, TEXT("SillyGeoEnemies"), GET_STATFNAME(STAT_SillyGeoEnemiesLLM), GET_STATFNAME(STAT_SillyGeoSummaryLLM));
+	Tracker.RegisterProjectTag((int32)ESillyGeoLLMTag::Projectiles, TEXT("SillyGeoProjectiles"), GET_STATFNAME(STAT_SillyGeoProjectilesLLM), GET_STATFNAME(STAT_SillyGeoSummaryLLM));
+	Tracker.RegisterProjectTag((int32)ESillyGeoLLMTag::FX, TEXT("SillyGeoFX"), GET_STATFNAME(STAT_SillyGeoFXLLM), GET_STATFNAME(STAT_SillyGeoSummaryLLM));
+	Tracker.RegisterProjectTag((int32)ESillyGeoLLMTag::DynamicMaterials, TEXT("SillyGeoMIDs"), GET_STATFNAME(STAT_SillyGeoDynamicMaterialsLLM), GET_STATFNAME(STAT_SillyGeoSummaryLLM));
+}
+
+#endif
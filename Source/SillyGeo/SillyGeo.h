@@ -3,10 +3,37 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "CoreGlobals.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "EnemyBase.h"
 #include "BitArray.h"
 #include "SillyGeo.generated.h"
 
+/**
+*	returns true when we are running as a dedicated server and cosmetic stuff
+*	(emitters, lights, reticle, dynamic materials, FX and sounds) should not be created at all.
+*	Cosmetic components are still created by constructors, so the class layout is the same
+*	everywhere, and are destroyed with StripCosmeticComponent in PostInitializeComponents.
+*	-KeepCosmetics on the server command line disables the stripping to compare the costs
+*/
+FORCEINLINE bool ShouldStripCosmetics()
+{
+	static const bool bStripCosmetics = IsRunningDedicatedServer() && !FParse::Param(FCommandLine::Get(), TEXT("KeepCosmetics"));
+	return bStripCosmetics;
+}
+
+/** [dedicated server] destroys cosmetic component created by the constructor and clears the reference */
+template<typename ComponentType>
+void StripCosmeticComponent(ComponentType*& Component)
+{
+	if (Component)
+	{
+		Component->DestroyComponent();
+		Component = nullptr;
+	}
+}
+
 /**
 *	specify the enemy template class and max amount of enemies of this type will
 	be spawned during the wave
@@ -0,0 +1,265 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SillyGeoBenchmarkGameMode.h"
+#include "ConstructorHelpers.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Geo.h"
+#include "EnemyBase.h"
+#include "Projectile.h"
+#include "GeoBotController.h"
+#include "GeoGameState.h"
+#include "GeoPlayerState.h"
+#include "GeoPlayerController.h"
+#include "SillyGeoStats.h"
+#include "Engine/GameInstance.h"
+
+ASillyGeoBenchmarkGameMode::ASillyGeoBenchmarkGameMode()
+{
+	/** the game mode blueprint sets these up for the regular game  */
+	static ConstructorHelpers::FClassFinder<AGeo> GeoClass(TEXT("/Game/BP/BP_Geo"));
+	static ConstructorHelpers::FClassFinder<AGeoPlayerController> PlayerControllerBPClass(TEXT("/Game/BP/BP_GeoPlayerController"));
+	static ConstructorHelpers::FClassFinder<AGeoGameState> GameStateBPClass(TEXT("/Game/BP/BP_GeoGameState"));
+	static ConstructorHelpers::FClassFinder<AGeoPlayerState> PlayerStateBPClass(TEXT("/Game/BP/BP_GeoPlayerState"));
+	if (GeoClass.Class) { DefaultPawnClass = GeoClass.Class; }
+	if (PlayerControllerBPClass.Class) { PlayerControllerClass = PlayerControllerBPClass.Class; }
+	if (GameStateBPClass.Class) { GameStateClass = GameStateBPClass.Class; }
+	if (PlayerStateBPClass.Class) { PlayerStateClass = PlayerStateBPClass.Class; }
+
+	/** one enemy of every color  */
+	static ConstructorHelpers::FClassFinder<AEnemyBase> RedEnemyClass(TEXT("/Game/BP/Enemy/BP_RedEnemy"));
+	static ConstructorHelpers::FClassFinder<AEnemyBase> GreenEnemyClass(TEXT("/Game/BP/Enemy/BP_GreenEnemy"));
+	static ConstructorHelpers::FClassFinder<AEnemyBase> BlueEnemyClass(TEXT("/Game/BP/Enemy/BP_BlueEnemy"));
+	static ConstructorHelpers::FClassFinder<AEnemyBase> YellowEnemyClass(TEXT("/Game/BP/Enemy/BP_YellowEnemy"));
+	for (TSubclassOf<AEnemyBase> EnemyClass : { RedEnemyClass.Class, GreenEnemyClass.Class, BlueEnemyClass.Class, YellowEnemyClass.Class })
+	{
+		if (EnemyClass)
+		{
+			EnemyTemplates.Add(EnemyClass);
+		}
+	}
+
+	BotControllerClass = AGeoBotController::StaticClass();
+
+	/** the local player only watches the bot  */
+	bStartPlayersAsSpectators = true;
+}
+
+void ASillyGeoBenchmarkGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	/** the same workload every run  */
+	RequestFixedStepSimulation();
+
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	FParse::Value(FCommandLine::Get(), TEXT("GeoBenchWaves="), BenchmarkWaves);
+	FParse::Value(FCommandLine::Get(), TEXT("GeoBenchViews="), BenchmarkViews);
+	BenchmarkViews = FMath::Clamp(BenchmarkViews, 1, 4);
+	if (BenchmarkViews > 1 && !FApp::CanEverRender())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Benchmark: -GeoBenchViews=%d without rendering (-nullrhi) measures no split-screen cost"), BenchmarkViews);
+	}
+	Report.SetViews(BenchmarkViews);
+
+	ReportName = FString::Printf(TEXT("SillyGeoBenchmark-%s"), *FDateTime::Now().ToString());
+	FParse::Value(FCommandLine::Get(), TEXT("GeoBenchReport="), ReportName);
+
+	BuildWaveTable();
+
+#if SILLYGEO_FRAME_COUNTERS
+	TArray<FString> CounterNames;
+	for (const TCHAR* CounterName : FSillyGeoFrameCounters::Names)
+	{
+		CounterNames.Add(CounterName);
+	}
+	Report.SetCounterNames(CounterNames);
+#endif
+
+	/** the game state isn't spawned yet, its defaults have the tiers */
+	if (const AGeoGameState* GeoGameStateDefaults = GameStateClass ? Cast<AGeoGameState>(GameStateClass->GetDefaultObject()) : nullptr)
+	{
+		TArray<FString> TierNames;
+		for (const FGeoQualitySettings& Tier : GeoGameStateDefaults->GetQualityTiers())
+		{
+			TierNames.Add(Tier.Name);
+		}
+		Report.SetQualityTierNames(TierNames);
+	}
+}
+
+void ASillyGeoBenchmarkGameMode::BuildWaveTable()
+{
+	const int32 NumTypes = EnemyTemplates.Num();
+	if (NumTypes == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Benchmark needs at least one enemy template!"));
+		return;
+	}
+
+	TArray<FWaveInfo> Waves;
+	WaveEnemies.Reset();
+	for (int32 i = 0; i < BenchmarkWaves; i++)
+	{
+		const int32 Enemies = FMath::Max(FMath::RoundToInt(FirstWaveEnemies * FMath::Pow(EnemyGrowth, (float)i)), 1);
+
+		FWaveInfo& Wave = Waves[Waves.AddDefaulted()];
+		for (int32 Type = 0; Type < NumTypes; Type++)
+		{
+			/** the remainder goes to the first types  */
+			FSpawnInfo& SpawnInfo = Wave.SpawnInfo[Wave.SpawnInfo.AddDefaulted()];
+			SpawnInfo.EnemyTemplate = EnemyTemplates[Type];
+			SpawnInfo.MaxEnemiesAmount = Enemies / NumTypes + (Type < Enemies % NumTypes ? 1 : 0);
+		}
+		WaveEnemies.Add(Enemies);
+	}
+
+	SetWaveTable(Waves, BenchmarkWaveDelay, BenchmarkSpawnDelay);
+}
+
+bool ASillyGeoBenchmarkGameMode::PlayerCanRestart_Implementation(APlayerController* Player)
+{
+	/** players never get a Geo, the bot plays  */
+	return false;
+}
+
+void ASillyGeoBenchmarkGameMode::StartMatch()
+{
+	/** split-screen players join as spectators, like the first one */
+	if (!HasMatchStarted() && GetGameInstance())
+	{
+		for (int32 View = GetGameInstance()->GetNumLocalPlayers(); View < BenchmarkViews; View++)
+		{
+			FString Error;
+			if (!GetGameInstance()->CreateLocalPlayer(-1, Error, true))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Benchmark can't add local player %d: %s"), View, *Error);
+				break;
+			}
+		}
+	}
+
+	/** pawns spawned before the match starts begin play after they are possessed */
+	if (!HasMatchStarted() && !BotController && BotControllerClass)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		BotController = GetWorld()->SpawnActor<AGeoBotController>(BotControllerClass, SpawnParams);
+		if (BotController)
+		{
+			RestartPlayer(BotController);
+			if (AGeo* Geo = Cast<AGeo>(BotController->GetPawn()))
+			{
+				Geo->SetInvulnerable(bInvulnerableBot);
+			}
+		}
+	}
+
+	Super::StartMatch();
+}
+
+void ASillyGeoBenchmarkGameMode::EndMatch()
+{
+	const bool bWasInProgress = IsMatchInProgress();
+
+	Super::EndMatch();
+
+	if (bWasInProgress)
+	{
+		FinishWave();
+		Report.Write(ReportName, GetWorld()->GetMapName());
+
+		if (bExitWhenDone)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+APawn* ASillyGeoBenchmarkGameMode::GetRandomPlayerPawn() const
+{
+	return BotController ? BotController->GetPawn() : nullptr;
+}
+
+void ASillyGeoBenchmarkGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (IsMatchInProgress())
+	{
+		SampleFrame();
+	}
+}
+
+void ASillyGeoBenchmarkGameMode::SampleFrame()
+{
+	const AGeoGameState* GeoGameState = GetGameState<AGeoGameState>();
+	if (!GeoGameState || GeoGameState->GetCurrentWave() < 1) { return; }
+
+	const double Now = FPlatformTime::Seconds();
+
+	/** a wave is measured from its start till the next wave starts, rest included */
+	FGeoBenchmarkWave* Wave = Report.GetCurrentWave();
+	if (!Wave || Wave->Wave != GeoGameState->GetCurrentWave())
+	{
+		FinishWave();
+
+		const int32 WaveNumber = GeoGameState->GetCurrentWave();
+		Wave = &Report.BeginWave(WaveNumber, WaveEnemies.IsValidIndex(WaveNumber - 1) ? WaveEnemies[WaveNumber - 1] : 0);
+		WaveStartTime = Now;
+		NextActorSampleTime = 0.f;
+	}
+
+	/** wall time, the game itself advances on fixed steps  */
+	if (LastFrameTime > 0.0)
+	{
+		Wave->FrameTimes.Add((float)((Now - LastFrameTime) * 1000.0));
+
+		/** no time in any tier without the governor  */
+		const int32 QualityTier = GeoGameState->GetQualityTier();
+		if (QualityTier != INDEX_NONE && Wave->QualityTierSeconds.IsValidIndex(QualityTier))
+		{
+			Wave->QualityTierSeconds[QualityTier] += Now - LastFrameTime;
+		}
+		Wave->GameThreadTimes.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+		Wave->RenderThreadTimes.Add(FPlatformTime::ToMilliseconds(GRenderThreadTime));
+
+#if SILLYGEO_FRAME_COUNTERS
+		/** the last finished frame, the same one GGameThreadTime measures */
+		for (int32 i = 0; i < FSillyGeoFrameCounters::Num && i < Wave->CounterTotalsMs.Num(); i++)
+		{
+			Wave->CounterTotalsMs[i] += FSillyGeoFrameCounters::LastFrameMs[i];
+		}
+#endif
+	}
+	LastFrameTime = Now;
+
+	const float GameTime = GetWorld()->GetTimeSeconds();
+	if (GameTime >= NextActorSampleTime)
+	{
+		NextActorSampleTime = GameTime + ActorSampleInterval;
+
+		int32 Enemies = 0;
+		int32 Projectiles = 0;
+		for (TActorIterator<AEnemyBase> It(GetWorld()); It; ++It) { if (!It->IsWarmUp()) { Enemies++; } }
+		for (TActorIterator<AProjectile> It(GetWorld()); It; ++It) { Projectiles++; }
+
+		Wave->MaxEnemies = FMath::Max(Wave->MaxEnemies, Enemies);
+		Wave->MaxProjectiles = FMath::Max(Wave->MaxProjectiles, Projectiles);
+		Wave->MaxActors = FMath::Max(Wave->MaxActors, GetWorld()->GetActorCount());
+		Wave->PeakUsedPhysicalMB = FMath::Max(Wave->PeakUsedPhysicalMB, FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f));
+	}
+}
+
+void ASillyGeoBenchmarkGameMode::FinishWave()
+{
+	FGeoBenchmarkWave* Wave = Report.GetCurrentWave();
+	if (!Wave) { return; }
+
+	Wave->Duration = FPlatformTime::Seconds() - WaveStartTime;
+	Wave->UsedPhysicalMB = FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f);
+	Wave->PeakUsedPhysicalMB = FMath::Max(Wave->PeakUsedPhysicalMB, Wave->UsedPhysicalMB);
+
+	UE_LOG(LogTemp, Log, TEXT("Benchmark wave %d: %d enemies, %d frames in %.1f s, %.1f MB used"),
+		Wave->Wave, Wave->Enemies, Wave->FrameTimes.Num(), Wave->Duration, Wave->UsedPhysicalMB);
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SillyGeoGameMode.h"
+#include "GeoBenchmarkReport.h"
+#include "SillyGeoBenchmarkGameMode.generated.h"
+
+/**
+*	headless performance benchmark: a bot drives Geo through a scripted wave table with escalating
+*	enemy counts on fixed steps, frame times, actor counts and memory of every wave are written
+*	to Saved/Profiling/Benchmark when the last wave ends.
+*	GeoMap?game=Benchmark -game -nullrhi -nosound -unattended [-GeoBenchWaves=N] [-GeoBenchReport=Name]
+*	Split-screen cost is measured with 1 to 4 local players watching the bot ( -GeoBenchViews=N ), it needs
+*	rendering, so run it without -nullrhi:
+*	GeoMap?game=Benchmark -game -nosound -unattended -GeoBenchViews=N [-GeoBenchWaves=N] [-GeoBenchReport=Name]
+*	Render thread times are for all views together, divide runs with different Views yourself
+*/
+UCLASS()
+class SILLYGEO_API ASillyGeoBenchmarkGameMode : public ASillyGeoGameMode
+{
+	GENERATED_BODY()
+
+public:
+
+	ASillyGeoBenchmarkGameMode();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** enemies chase the bot  */
+	virtual class APawn* GetRandomPlayerPawn() const override;
+
+protected:
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/** players only watch the bot  */
+	virtual bool PlayerCanRestart_Implementation(APlayerController* Player) override;
+
+	/** spawns the bot before players get their pawns  */
+	virtual void StartMatch() override;
+
+	/** writes the report and quits  */
+	virtual void EndMatch() override;
+
+private:
+
+	/** calls to build escalating wave table out of EnemyTemplates  */
+	void BuildWaveTable();
+
+	/** [tick] calls to measure this frame  */
+	void SampleFrame();
+
+	/** calls to finish measuring current wave  */
+	void FinishWave();
+
+	/** enemy types spawned by every wave, in equal amounts  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	TArray<TSubclassOf<class AEnemyBase>> EnemyTemplates;
+
+	/** waves to play ( -GeoBenchWaves=N )  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	int32 BenchmarkWaves = 10;
+
+	/** enemies of the first wave  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	int32 FirstWaveEnemies = 20;
+
+	/** every next wave has EnemyGrowth times more enemies  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float EnemyGrowth = 1.5f;
+
+	/** the delay between enemies spawning during the benchmark  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float BenchmarkSpawnDelay = 0.05f;
+
+	/** the delay between waves during the benchmark  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float BenchmarkWaveDelay = 2.f;
+
+	/** the bot that plays the benchmark  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class AGeoBotController> BotControllerClass;
+
+	/** if true, the bot never dies, so every run plays all waves with the same load */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	bool bInvulnerableBot = true;
+
+	/** how often (in sec) live actors and memory are sampled  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float ActorSampleInterval = 0.5f;
+
+	/** local players watching the bot, every one renders its own split-screen view */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	int32 BenchmarkViews = 1;
+
+	/** if true, the game quits once the report is written  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	bool bExitWhenDone = true;
+
+	/** the bot  */
+	UPROPERTY(Transient)
+	class AGeoBotController* BotController;
+
+	/** report file name ( -GeoBenchReport=Name )  */
+	FString ReportName;
+
+	/** enemies of each benchmark wave  */
+	TArray<int32> WaveEnemies;
+
+	/** results  */
+	FGeoBenchmarkReport Report;
+
+	/** wall time of the last sampled frame and of the current wave start */
+	double LastFrameTime = 0.0;
+	double WaveStartTime = 0.0;
+
+	/** the time (game time) we sample live actors again  */
+	float NextActorSampleTime = 0.f;
+};
@@ -6,16 +6,246 @@
 #include "EnemySpawner.h"
 #include "GeoGameState.h"
 #include "GeoPlayerController.h"
+#include "Projectile.h"
+#include "EngineUtils.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Components/PointLightComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/Crc.h"
+#include "GeoInputRecording.h"
+#include "GeoArenaSnapshot.h"
+#include "GeoWaveDataAsset.h"
+#include "UObject/SoftObjectPath.h"
+#include "SillyGeoStats.h"
+#include "Engine/Engine.h"
+#include "GeoPlayerState.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "UObject/UObjectGlobals.h"
+
+ASillyGeoGameMode::ASillyGeoGameMode()
+{
+	/** the state hash is taken after everything has moved  */
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+}
+
+void ASillyGeoGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	/** inline waves hard reference every enemy class, so all of them stay in memory the whole match */
+	if (WaveAssets.Num() > 0)
+	{
+		if (WaveInfo.Num() > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: inline WaveInfo (%d waves) is ignored, WaveAssets replace it"), *GetClass()->GetName(), WaveInfo.Num());
+		}
+		BuildWaveTableFromAssets();
+	}
+	else if (WaveInfo.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: inline WaveInfo is used, wave streaming is off. Move the waves into UGeoWaveDataAsset and list them in WaveAssets"), *GetClass()->GetName());
+	}
+
+	/** command line overrides  */
+	bFixedStepSimulation |= FParse::Param(FCommandLine::Get(), TEXT("GeoFixedStep"));
+	bLogFrameStateHash |= FParse::Param(FCommandLine::Get(), TEXT("GeoLogStateHash"));
+	FParse::Value(FCommandLine::Get(), TEXT("GeoSeed="), SimulationSeed);
+	FParse::Value(FCommandLine::Get(), TEXT("GeoSnapshot="), StartupSnapshot);
+	bTrackObjectChurn |= FParse::Param(FCommandLine::Get(), TEXT("GeoTrackChurn"));
+	bWriteTelemetry |= FParse::Param(FCommandLine::Get(), TEXT("GeoTelemetry"));
+
+	/** input recordings are played with the step and seed they were recorded with */
+	FString InputPath;
+	FGeoInputHeader InputHeader;
+	if (FParse::Value(FCommandLine::Get(), TEXT("GeoReplay="), InputPath) && FGeoInputHeader::Read(FGeoInputHeader::GetFullPath(InputPath), InputHeader))
+	{
+		bFixedStepSimulation = true;
+		FixedStepRate = InputHeader.StepRate;
+		SimulationSeed = InputHeader.Seed;
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("GeoRecord="), InputPath))
+	{
+		bFixedStepSimulation = true;
+	}
+
+	/** clients and server run on their own clocks, so only standalone games can be stepped */
+	if (bFixedStepSimulation && GetNetMode() == NM_Standalone)
+	{
+		BeginFixedStepSimulation();
+	}
+}
 
 void ASillyGeoGameMode::BeginPlay()
 {
 	Super::BeginPlay();
 	
 	UpdateHUD();
+	PreloadAssets();
+	StreamWave(0);
+
+	SpawnDirector.TargetGameThreadMs = SpawnTargetGameThreadMs;
+	SpawnDirector.MaxSlowdown = MaxSpawnSlowdown;
+	SpawnDirector.MinAliveCap = MinAliveEnemiesCap;
+
+	BlastResolver.ChainRadius = ChainBlastRadius;
+	BlastResolver.ChainDamage = ChainBlastDamage;
+	BlastResolver.MaxChainDepth = MaxChainBlastDepth;
+
+	PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ASillyGeoGameMode::OnPostGarbageCollect);
+
+	if (bTrackObjectChurn)
+	{
+		ObjectChurn = MakeUnique<FGeoObjectChurnTracker>();
+		ObjectChurn->Start();
+	}
+
+	if (bWriteTelemetry)
+	{
+		const FString Path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"),
+			FString::Printf(TEXT("%s-%s.jsonl"), *GetWorld()->GetMapName(), *FDateTime::Now().ToString()));
+		Telemetry = MakeUnique<FGeoTelemetry>();
+		if (!Telemetry->Open(Path, GetWorld()))
+		{
+			Telemetry.Reset();
+		}
+	}
+}
+
+void ASillyGeoGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bFixedStepActive)
+	{
+		LogStateHash();
+		EndFixedStepSimulation();
+	}
+
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+
+	/** logs the last wave  */
+	ObjectChurn.Reset();
+
+	/** writes the rest of the stream  */
+	Telemetry.Reset();
+
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->ReleaseHandle();
+		PreloadHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASillyGeoGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	/** holds for one frame, so it is requested every frame of the wave */
+	if (GEngine && ShouldDeferGarbageCollection())
+	{
+		GEngine->DelayGarbageCollection();
+	}
+
+	if (PendingWarmUpWave != INDEX_NONE)
+	{
+		WarmUpWave(PendingWarmUpWave);
+	}
+
+	if (IsSpawnDirected())
+	{
+		UpdateSpawnDirector();
+	}
+
+	if (Telemetry)
+	{
+		Telemetry->AddFrame(FApp::GetDeltaTime() * 1000.f, FPlatformTime::ToMilliseconds(GGameThreadTime));
+	}
+
+	if (bFixedStepActive)
+	{
+		const uint32 FrameHash = (uint32)ComputeStateHash();
+		StateHash = FCrc::MemCrc32(&FrameHash, sizeof(FrameHash), StateHash);
+		StateHashFrames++;
+
+		if (bLogFrameStateHash)
+		{
+			UE_LOG(LogTemp, Log, TEXT("State hash: frame %d, %08X"), StateHashFrames, FrameHash);
+		}
+	}
+}
+
+void ASillyGeoGameMode::UpdateSpawnDirector()
+{
+	if (!GeoGameState) { return; }
+
+	const bool bChanged = SpawnDirector.Update(FPlatformTime::ToMilliseconds(GGameThreadTime), GeoGameState->GetEnemiesRemaining(), FApp::GetDeltaTime());
+
+	SET_FLOAT_STAT(STAT_SpawnDirectorInterval, SpawnDirector.GetSpawnInterval());
+	SET_DWORD_STAT(STAT_SpawnDirectorAliveCap, SpawnDirector.GetAliveCap());
+	SET_FLOAT_STAT(STAT_SpawnDirectorGameThreadMs, SpawnDirector.GetAvgGameThreadMs());
+
+	if (!bChanged) { return; }
+
+	UE_LOG(LogTemp, Verbose, TEXT("Spawn director: interval %.2f s, alive cap %d (game thread %.1f ms)"),
+		SpawnDirector.GetSpawnInterval(), SpawnDirector.GetAliveCap(), SpawnDirector.GetAvgGameThreadMs());
+
+	if (Telemetry)
+	{
+		Telemetry->Push(EGeoTelemetryEvent::SpawnDirector, INDEX_NONE, NAME_None, SpawnDirector.GetSpawnInterval(), (float)SpawnDirector.GetAliveCap(), SpawnDirector.GetAvgGameThreadMs());
+	}
+
+	/** the spawn in progress keeps its remaining time if it is shorter */
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (TimerManager.IsTimerActive(SpawnTimerHandle))
+	{
+		const float Interval = SpawnDirector.GetSpawnInterval();
+		const float FirstDelay = FMath::Min(TimerManager.GetTimerRemaining(SpawnTimerHandle), Interval);
+		TimerManager.SetTimer(SpawnTimerHandle, this, &ASillyGeoGameMode::SpawnEnemy, Interval, true, FMath::Max(FirstDelay, KINDA_SMALL_NUMBER));
+	}
+}
+
+void ASillyGeoGameMode::BeginFixedStepSimulation()
+{
+	bPrevUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PrevFixedDeltaTime = FApp::GetFixedDeltaTime();
+
+	/** Tick, timers (spawn, waves, fire, regeneration, enemy tracking) and movement
+	*	components all take their delta from the engine clock
+	*/
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FMath::Max(FixedStepRate, 1.f));
+
+	/** global RNG feeds spawn locations, targets and enemy steering seeds  */
+	FMath::RandInit(SimulationSeed);
+	FMath::SRandInit(SimulationSeed);
+
+	bFixedStepActive = true;
+	StateHash = 0;
+	StateHashFrames = 0;
+
+	UE_LOG(LogTemp, Log, TEXT("Fixed step simulation: %.0f steps per second, seed %d"), FixedStepRate, SimulationSeed);
+}
+
+void ASillyGeoGameMode::EndFixedStepSimulation()
+{
+	FApp::SetUseFixedTimeStep(bPrevUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PrevFixedDeltaTime);
+	bFixedStepActive = false;
+}
+
+void ASillyGeoGameMode::LogStateHash() const
+{
+	UE_LOG(LogTemp, Log, TEXT("State hash: %08X after %d frames (seed %d)"), StateHash, StateHashFrames, SimulationSeed);
 }
 
 void ASillyGeoGameMode::UpdateHUD()
 {	
+	SILLYGEO_SCOPE_COUNTER(STAT_GameModeUpdateHUD, GameModeUpdateHUD);
+
 	for (AGeoPlayerController* GeoPC : PlayerControllerList)
 	{
 		if (GeoPC)
@@ -25,14 +255,96 @@ void ASillyGeoGameMode::UpdateHUD()
 	}
 }
 
+void ASillyGeoGameMode::OnEnemiesKilled(const TArray<AEnemyBase*>& Killed, AController* Killer)
+{
+	if (Killed.Num() == 0) { return; }
+
+	/** add enemies killed to player state  */
+	int32 KillerId = INDEX_NONE;
+	const AGeo* Geo = Killer ? Cast<AGeo>(Killer->GetPawn()) : nullptr;
+	if (AGeoPlayerState* GeoPlayerState = Geo ? Cast<AGeoPlayerState>(Geo->PlayerState) : nullptr)
+	{
+		GeoPlayerState->AddEnemiesKilled(Killed.Num());
+		KillerId = GeoPlayerState->PlayerId;
+	}
+
+	if (!GeoGameState) { return; }
+
+	/** before EndWave, so the last kills land in their wave */
+	if (Telemetry)
+	{
+		for (const AEnemyBase* Enemy : Killed)
+		{
+			Telemetry->Push(EGeoTelemetryEvent::EnemyKilled, KillerId, Enemy->GetClass()->GetFName());
+		}
+	}
+
+	GeoGameState->AddEnemiesRemaining(-Killed.Num());
+	UpdateHUD();
+
+	/** if we haven't alive enemies on map and we haven't enemies to spawn */
+	if (GeoGameState->GetEnemiesRemaining() <= 0 && !HasEnemiesToSpawn())
+	{
+		EndWave();
+	}
+}
+
+void ASillyGeoGameMode::ResolveBlast(const FVector& Location, float Radius, float Damage, EEnemyColor Color, AController* Instigator)
+{
+	SILLYGEO_SCOPE_COUNTER(STAT_GameModeResolveBlast, GameModeResolveBlast);
+
+	if (!GeoGameState) { return; }
+
+	BlastKills.Reset();
+	BlastResolver.Resolve(GeoGameState->GetEnemyIndex(), Location, Radius, Damage, Color, BlastKills);
+	if (BlastKills.Num() == 0) { return; }
+
+	INC_DWORD_STAT_BY(STAT_BlastKills, BlastKills.Num());
+	OnEnemiesKilled(BlastKills, Instigator);
+
+	/** before they die, so clients get it ahead of the removal of their entries */
+	if (BlastKills.Num() > 1 && GetNetMode() != NM_Standalone)
+	{
+		BlastQuietIds.Reset();
+		for (int32 i = 1; i < BlastKills.Num(); i++)
+		{
+			BlastQuietIds.Add(BlastKills[i]->GetNetId());
+		}
+		GeoGameState->MulticastBlastKills(BlastQuietIds);
+	}
+
+	/** one explosion for the whole batch, on the first enemy the impact killed  */
+	for (int32 i = 0; i < BlastKills.Num(); i++)
+	{
+		BlastKills[i]->Die(i == 0);
+	}
+	BlastKills.Reset();
+}
+
 void ASillyGeoGameMode::BeginWave()
 {
 	GetWorldTimerManager().ClearTimer(WaveTimerHandle);
+
+	/** too late, the first enemies of the wave warm it up now  */
+	PendingWarmUpWave = INDEX_NONE;
 	
 	if (GeoGameState)
 	{
 		GeoGameState->SetWaveActive(true);
 		GeoGameState->SetCurrentWave(GeoGameState->GetCurrentWave() + 1);
+		WaveStartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		WaveStartTime = GetWorld()->GetTimeSeconds();
+		EnsureWaveResident(GeoGameState->GetCurrentWave() - 1);
+		if (ObjectChurn)
+		{
+			ObjectChurn->BeginWave(GeoGameState->GetCurrentWave());
+		}
+		if (Telemetry)
+		{
+			const int32 Wave = GeoGameState->GetCurrentWave();
+			Telemetry->SetWave(Wave);
+			Telemetry->Push(EGeoTelemetryEvent::WaveStart, INDEX_NONE, NAME_None, WaveInfo.IsValidIndex(Wave - 1) ? (float)WaveInfo[Wave - 1].MaxEnemiesThisWave : 0.f);
+		}
 		UpdateHUD();
 		BeginSpawning();
 	}
@@ -40,16 +352,53 @@ void ASillyGeoGameMode::BeginWave()
 
 void ASillyGeoGameMode::EndWave()
 {
+	/** checkpoint to compare runs wave by wave  */
+	if (bFixedStepActive)
+	{
+		LogStateHash();
+	}
+
 	if (GeoGameState)
 	{
 		GeoGameState->SetWaveActive(false);
 		UpdateHUD();
+		LogWaveMemory();
+
+		if (ObjectChurn)
+		{
+			ObjectChurn->EndCombat();
+		}
+		/** StartMatch ends the wave 0 to begin the first rest  */
+		if (Telemetry && GeoGameState->GetCurrentWave() > 0)
+		{
+			for (AGeoPlayerController* GeoPC : PlayerControllerList)
+			{
+				if (const AGeoPlayerState* GeoPlayerState = GeoPC ? Cast<AGeoPlayerState>(GeoPC->PlayerState) : nullptr)
+				{
+					Telemetry->Push(EGeoTelemetryEvent::PlayerKills, GeoPlayerState->PlayerId, NAME_None, (float)GeoPlayerState->GetEnemiesKilled());
+				}
+			}
+			Telemetry->Push(EGeoTelemetryEvent::WaveEnd, INDEX_NONE, NAME_None, GetWorld()->GetTimeSeconds() - WaveStartTime);
+		}
+
+		if (GetNetMode() == NM_DedicatedServer)
+		{
+			ReportServerCost();
+		}
 		if (GeoGameState->GetCurrentWave() >= MaxWaves)
 		{
 			EndMatch();
 		}
 		else
 		{
+			/** collect the garbage of the wave while players rest  */
+			if (bForceGCBetweenWaves && GEngine)
+			{
+				GEngine->ForceGarbageCollection(false);
+			}
+			/** the wave is over, its enemies are not needed till the end of the match */
+			ReleaseWave(GeoGameState->GetCurrentWave() - 1);
+			PrepareWave(GeoGameState->GetCurrentWave());
 			GetWorldTimerManager().SetTimer(WaveTimerHandle, this, &ASillyGeoGameMode::BeginWave, WaveDelay, false);
 		}
 	}
@@ -71,13 +420,23 @@ void ASillyGeoGameMode::BeginSpawning()
 			EnemyToSpawn = 0;
 			EnemiesSpawned = 0;
 
-			GetWorldTimerManager().SetTimer(SpawnTimerHandle, this, &ASillyGeoGameMode::SpawnEnemy, SpawnDelay, true);
+			GetWorldTimerManager().SetTimer(SpawnTimerHandle, this, &ASillyGeoGameMode::SpawnEnemy, BeginSpawnPacing(), true);
 		}
 	}
 }
 
+float ASillyGeoGameMode::BeginSpawnPacing()
+{
+	if (!IsSpawnDirected()) { return SpawnDelay; }
+
+	SpawnDirector.BeginWave(SpawnDelay);
+	return SpawnDirector.GetSpawnInterval();
+}
+
 void ASillyGeoGameMode::SpawnEnemy()
 {
+	SILLYGEO_SCOPE_COUNTER(STAT_GameModeSpawnEnemy, GameModeSpawnEnemy);
+
 	/** no spawner instance in the level  */
 	if (!ensure(Spawner)) { return; }
 
@@ -88,6 +447,13 @@ void ASillyGeoGameMode::SpawnEnemy()
 		GetWorldTimerManager().ClearTimer(SpawnTimerHandle);
 	}
 
+	/** too many enemies alive for the load, the spawn is held till the next tick of the timer */
+	if (GeoGameState && IsSpawnDirected() && !SpawnDirector.CanSpawn(GeoGameState->GetEnemiesRemaining()))
+	{
+		INC_DWORD_STAT(STAT_SpawnDirectorHeldSpawns);
+		return;
+	}
+
 	if (GeoGameState)
 	{
 		int32 CurrentWave = GeoGameState->GetCurrentWave();
@@ -110,6 +476,10 @@ void ASillyGeoGameMode::SpawnEnemy()
 							if (SpawnedEnemy)
 							{
 								SpawnedEnemy->InitReferences(this, GeoGameState);
+								if (Telemetry)
+								{
+									Telemetry->Push(EGeoTelemetryEvent::EnemySpawned, INDEX_NONE, SpawnInfo.EnemyTemplate->GetFName());
+								}
 								EnemiesSpawned++;
 								SpawnedOfType[EnemyToSpawn]++;
 								GeoGameState->AddEnemiesRemaining(1);
@@ -159,16 +529,155 @@ void ASillyGeoGameMode::Logout(AController* Exiting)
 	}
 }
 
+void ASillyGeoGameMode::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (const AGeo* GeoDefaults = DefaultPawnClass ? Cast<AGeo>(DefaultPawnClass->GetDefaultObject()) : nullptr)
+	{
+		GeoDefaults->GetPreloadAssets(OutAssets);
+	}
+	for (const FWaveInfo& Wave : WaveInfo)
+	{
+		for (const FSpawnInfo& Info : Wave.SpawnInfo)
+		{
+			if (Info.EnemyTemplate)
+			{
+				Info.EnemyTemplate->GetDefaultObject<AEnemyBase>()->GetPreloadAssets(OutAssets);
+			}
+		}
+	}
+}
+
+void ASillyGeoGameMode::PreloadAssets()
+{
+	TArray<FSoftObjectPath> Assets;
+	GetPreloadAssets(Assets);
+
+	if (Assets.Num() == 0) { return; }
+
+	PreloadStartTime = FPlatformTime::Seconds();
+	PreloadHandle = StreamableManager.RequestAsyncLoad(Assets, FStreamableDelegate::CreateUObject(this, &ASillyGeoGameMode::OnAssetsPreloaded), FStreamableManager::AsyncLoadHighPriority);
+	UE_LOG(LogTemp, Log, TEXT("Preloading %d assets"), Assets.Num());
+}
+
+void ASillyGeoGameMode::OnAssetsPreloaded()
+{
+	PreloadDuration = FPlatformTime::Seconds() - PreloadStartTime;
+	UE_LOG(LogTemp, Log, TEXT("Assets preloaded in %.3f s"), PreloadDuration);
+}
+
+void ASillyGeoGameMode::WarmUpWave(int32 WaveIndex)
+{
+	PendingWarmUpWave = INDEX_NONE;
+
+	/** nothing is rendered on a dedicated server  */
+	UWorld* const World = GetWorld();
+	if (!World || !WaveInfo.IsValidIndex(WaveIndex) || GetNetMode() == NM_DedicatedServer) { return; }
+
+	/** copies must be in sight of a local camera, till it exists Tick retries */
+	APlayerController* ViewPC = nullptr;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalPlayerController() && PC->GetPawn() && PC->PlayerCameraManager)
+		{
+			ViewPC = PC;
+			break;
+		}
+	}
+	if (!ViewPC)
+	{
+		PendingWarmUpWave = WaveIndex;
+		return;
+	}
+
+	/** right in front of the camera nothing can hide them, at this scale they cover a few pixels */
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	ViewPC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	const FTransform WarmUpTransform(ViewRotation, ViewLocation + ViewRotation.Vector() * WarmUpDistance, FVector(WarmUpScale));
+
+	for (const FSpawnInfo& Info : WaveInfo[WaveIndex].SpawnInfo)
+	{
+		UClass* EnemyClass = Info.EnemyTemplate;
+		if (!EnemyClass || WarmedUpClasses.Contains(EnemyClass)) { continue; }
+
+		SILLYGEO_LLM_SCOPE(Enemies);
+		AEnemyBase* Enemy = World->SpawnActorDeferred<AEnemyBase>(EnemyClass, WarmUpTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Enemy)
+		{
+			Enemy->InitWarmUp(WarmUpLifeSpan);
+			Enemy->FinishSpawning(WarmUpTransform);
+			WarmedUpClasses.Add(EnemyClass);
+		}
+	}
+}
+
+void ASillyGeoGameMode::PrepareWave(int32 WaveIndex)
+{
+	if (!WaveStreaming.IsValidIndex(WaveIndex))
+	{
+		if (bWarmUpNextWave)
+		{
+			WarmUpWave(WaveIndex);
+		}
+		return;
+	}
+
+	WaveStreaming[WaveIndex].bWarmUpWhenResident = bWarmUpNextWave;
+	if (WaveStreaming[WaveIndex].bResident)
+	{
+		OnWaveContentStreamed(WaveIndex);
+	}
+	else
+	{
+		StreamWave(WaveIndex);
+	}
+}
+
+bool ASillyGeoGameMode::ReadyToStartMatch_Implementation()
+{
+	if (PreloadHandle.IsValid() && PreloadHandle->IsLoadingInProgress())
+	{
+		return false;
+	}
+	if (WaveStreaming.IsValidIndex(0) && WaveStreaming[0].IsStreaming())
+	{
+		return false;
+	}
+
+	return Super::ReadyToStartMatch_Implementation();
+}
+
 void ASillyGeoGameMode::StartMatch()
 {
 	// Returns true if the match state is InProgress or later
 	if (!HasMatchStarted())
 	{
+		/** from process launch to the first frame players can play  */
+		UE_LOG(LogTemp, Log, TEXT("Startup: match starts %.3f s after launch (asset preload %.3f s)"), FPlatformTime::Seconds() - GStartTime, PreloadDuration);
+
+		if (Telemetry)
+		{
+			Telemetry->Push(EGeoTelemetryEvent::MatchStart, INDEX_NONE, FName(*GetWorld()->GetMapName()));
+		}
+
 		EndWave();
 	}
 
 	Super::StartMatch();
 	UpdateHUD();
+
+	/** players get their pawns in StartMatch, so wait a tick for them to begin play */
+	if (!StartupSnapshot.IsEmpty())
+	{
+		GetWorldTimerManager().SetTimerForNextTick(this, &ASillyGeoGameMode::LoadStartupSnapshot);
+	}
+}
+
+void ASillyGeoGameMode::LoadStartupSnapshot()
+{
+	LoadArenaSnapshot(StartupSnapshot);
+	StartupSnapshot.Empty();
 }
 
 void ASillyGeoGameMode::EndMatch()
@@ -176,6 +685,11 @@ void ASillyGeoGameMode::EndMatch()
 	Super::EndMatch();
 	
 	UpdateHUD();
+
+	if (Telemetry)
+	{
+		Telemetry->Push(EGeoTelemetryEvent::MatchEnd);
+	}
 	
 	for (AGeoPlayerController* GeoPC : PlayerControllerList)
 	{
@@ -230,8 +744,550 @@ class APawn* ASillyGeoGameMode::GetRandomPlayerPawn() const
 	return nullptr;
 }
 
-#if WITH_EDITOR
-void ASillyGeoGameMode::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+void ASillyGeoGameMode::ReportServerCost() const
+{
+	UWorld* const World = GetWorld();
+	if (!World) { return; }
+
+	int32 Enemies = 0;
+	int32 Projectiles = 0;
+	for (TActorIterator<AEnemyBase> It(World); It; ++It) { if (!It->IsWarmUp()) { Enemies++; } }
+	for (TActorIterator<AProjectile> It(World); It; ++It) { Projectiles++; }
+
+	int32 Emitters = 0;
+	int32 Lights = 0;
+	int32 DynamicMaterials = 0;
+	for (TObjectIterator<UParticleSystemComponent> It; It; ++It) { Emitters++; }
+	for (TObjectIterator<UPointLightComponent> It; It; ++It) { Lights++; }
+	for (TObjectIterator<UMaterialInstanceDynamic> It; It; ++It) { DynamicMaterials++; }
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	UE_LOG(LogTemp, Log, TEXT("Server cost (cosmetics %s): Enemies %d, Projectiles %d, Emitters %d, Lights %d, MIDs %d, UsedPhysical %.2f MB, Frame %.2f ms, GameThread %.2f ms"),
+		ShouldStripCosmetics() ? TEXT("stripped") : TEXT("kept"),
+		Enemies, Projectiles, Emitters, Lights, DynamicMaterials,
+		MemoryStats.UsedPhysical / (1024.f * 1024.f),
+		FApp::GetDeltaTime() * 1000.f,
+		FPlatformTime::ToMilliseconds(GGameThreadTime));
+}
+
+bool ASillyGeoGameMode::ShouldDeferGarbageCollection() const
+{
+	if (!bDeferGCDuringCombat || !GeoGameState || !GeoGameState->IsWaveActive())
+	{
+		return false;
+	}
+
+	/** too long waves pile up too much garbage  */
+	return GetWorld()->GetTimeSeconds() - WaveStartTime < MaxGCDeferTime;
+}
+
+void ASillyGeoGameMode::LogWaveMemory()
+{
+	UWorld* const World = GetWorld();
+	if (!World || !GeoGameState) { return; }
+
+	const uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	auto ToMB = [](uint64 Bytes) { return Bytes / (1024.f * 1024.f); };
+
+	/** objects that outlive their wave show up here, even if the total memory doesn't grow yet */
+	int32 Emitters = 0;
+	int32 DynamicMaterials = 0;
+	for (TObjectIterator<UParticleSystemComponent> It; It; ++It) { if (It->GetWorld() == World) { Emitters++; } }
+	for (TObjectIterator<UMaterialInstanceDynamic> It; It; ++It) { if (It->GetWorld() == World) { DynamicMaterials++; } }
+
+	/** "since last wave" must stay near zero from wave to wave, otherwise something leaks */
+	UE_LOG(LogTemp, Log, TEXT("Wave %d memory: UsedPhysical %.2f MB, during wave %+.2f MB, since last wave %+.2f MB, Emitters %d, MIDs %d"),
+		GeoGameState->GetCurrentWave(),
+		ToMB(UsedPhysical),
+		ToMB(UsedPhysical) - ToMB(WaveStartUsedPhysical),
+		LastWaveEndUsedPhysical > 0 ? ToMB(UsedPhysical) - ToMB(LastWaveEndUsedPhysical) : 0.f,
+		Emitters, DynamicMaterials);
+
+	LastWaveEndUsedPhysical = UsedPhysical;
+}
+
+int32 ASillyGeoGameMode::ComputeStateHash() const
+{
+	uint32 Crc = 0;
+	auto HashValue = [&Crc](const void* Data, int32 Size) { Crc = FCrc::MemCrc32(Data, Size, Crc); };
+
+	UWorld* const World = GetWorld();
+	if (!World) { return 0; }
+
+	/** actor iteration order follows spawn order, so it is the same in identical runs */
+	for (TActorIterator<AGeo> It(World); It; ++It)
+	{
+		const FVector Location = It->GetActorLocation();
+		const FVector Velocity = It->GetVelocity();
+		const float Health = It->GetHealth();
+		HashValue(&Location, sizeof(Location));
+		HashValue(&Velocity, sizeof(Velocity));
+		HashValue(&Health, sizeof(Health));
+	}
+	for (TActorIterator<AEnemyBase> It(World); It; ++It)
+	{
+		if (It->IsWarmUp()) { continue; }
+
+		const FVector Location = It->GetActorLocation();
+		const FVector Velocity = It->GetVelocity();
+		const float Health = It->GetHealth();
+		HashValue(&Location, sizeof(Location));
+		HashValue(&Velocity, sizeof(Velocity));
+		HashValue(&Health, sizeof(Health));
+	}
+	for (TActorIterator<AProjectile> It(World); It; ++It)
+	{
+		const FVector Location = It->GetActorLocation();
+		HashValue(&Location, sizeof(Location));
+	}
+	if (GeoGameState)
+	{
+		const int32 Counters[] = { GeoGameState->GetEnemiesRemaining(), GeoGameState->GetCurrentWave(), GeoGameState->IsWaveActive() ? 1 : 0 };
+		HashValue(Counters, sizeof(Counters));
+	}
+	return (int32)Crc;
+}
+
+// -------------- A R E N A   S N A P S H O T --------------------------------
+
+void ASillyGeoGameMode::SaveArenaSnapshot(const FString& Name)
+{
+	FGeoArenaSnapshot Snapshot;
+	CaptureArenaSnapshot(Snapshot);
+
+	const FString Path = FGeoArenaSnapshot::GetFullPath(Name);
+	if (Snapshot.Save(Path))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Arena snapshot saved to %s: wave %d, %d enemies, %d projectiles"), *Path, Snapshot.CurrentWave, Snapshot.Enemies.Num(), Snapshot.Projectiles.Num());
+	}
+}
+
+void ASillyGeoGameMode::LoadArenaSnapshot(const FString& Name)
+{
+	FGeoArenaSnapshot Snapshot;
+	if (Snapshot.Load(FGeoArenaSnapshot::GetFullPath(Name)))
+	{
+		RestoreArenaSnapshot(Snapshot);
+	}
+}
+
+void ASillyGeoGameMode::GetPlayerGeos(TArray<class AGeo*>& OutGeos) const
+{
+	OutGeos.Reset();
+	for (AGeoPlayerController* GeoPC : PlayerControllerList)
+	{
+		if (AGeo* Geo = GeoPC ? Cast<AGeo>(GeoPC->GetPawn()) : nullptr)
+		{
+			OutGeos.Add(Geo);
+		}
+	}
+}
+
+void ASillyGeoGameMode::CaptureArenaSnapshot(FGeoArenaSnapshot& OutSnapshot) const
+{
+	OutSnapshot = FGeoArenaSnapshot();
+
+	UWorld* const World = GetWorld();
+	if (!World || !GeoGameState) { return; }
+
+	OutSnapshot.MapName = World->GetMapName();
+
+	OutSnapshot.CurrentWave = GeoGameState->GetCurrentWave();
+	OutSnapshot.EnemiesRemaining = GeoGameState->GetEnemiesRemaining();
+	OutSnapshot.bWaveActive = GeoGameState->IsWaveActive();
+
+	OutSnapshot.EnemyToSpawn = EnemyToSpawn;
+	OutSnapshot.EnemiesSpawned = EnemiesSpawned;
+	OutSnapshot.SpawnedOfType = SpawnedOfType;
+
+	/** returns -1 for inactive timers  */
+	OutSnapshot.SpawnTimerRemaining = GetWorldTimerManager().GetTimerRemaining(SpawnTimerHandle);
+	OutSnapshot.WaveTimerRemaining = GetWorldTimerManager().GetTimerRemaining(WaveTimerHandle);
+
+	TArray<AGeo*> Geos;
+	GetPlayerGeos(Geos);
+	for (AGeo* Geo : Geos)
+	{
+		FGeoPawnSnapshot& GeoState = OutSnapshot.Geos[OutSnapshot.Geos.AddDefaulted()];
+		GeoState.Location = Geo->GetActorLocation();
+		GeoState.Velocity = Geo->GetVelocity();
+		GeoState.Health = Geo->GetHealth();
+		GeoState.Weapon = (uint8)Geo->GetCurrentWeapon();
+	}
+
+	for (TActorIterator<AEnemyBase> It(World); It; ++It)
+	{
+		/** clients' copies of replicated enemies aren't the arena state  */
+		if (It->IsNetProxy() || It->IsWarmUp() || It->IsPendingKill()) { continue; }
+
+		FGeoEnemySnapshot& EnemyState = OutSnapshot.Enemies[OutSnapshot.Enemies.AddDefaulted()];
+		EnemyState.ClassIndex = OutSnapshot.GetClassIndex(It->GetClass());
+		EnemyState.Location = FVector2D(It->GetActorLocation());
+		EnemyState.Velocity = FVector2D(It->GetVelocity());
+		EnemyState.Yaw = It->GetActorRotation().Yaw;
+		EnemyState.Health = It->GetHealth();
+		EnemyState.Color = (uint8)It->GetColorType();
+	}
+
+	for (TActorIterator<AProjectile> It(World); It; ++It)
+	{
+		if (It->IsPendingKill()) { continue; }
+
+		FGeoProjectileSnapshot& ProjectileState = OutSnapshot.Projectiles[OutSnapshot.Projectiles.AddDefaulted()];
+		ProjectileState.ClassIndex = OutSnapshot.GetClassIndex(It->GetClass());
+		ProjectileState.OwnerIndex = (int8)Geos.IndexOfByKey(Cast<AGeo>(It->GetOwner()));
+		ProjectileState.Location = It->GetActorLocation();
+		ProjectileState.Yaw = It->GetActorRotation().Yaw;
+		ProjectileState.Weapon = (uint8)It->GetWeapon();
+		ProjectileState.Color = It->GetProjectileColor();
+		ProjectileState.InheritedSpeed = It->GetInheritedSpeed();
+	}
+}
+
+bool ASillyGeoGameMode::RestoreArenaSnapshot(const FGeoArenaSnapshot& Snapshot)
+{
+	UWorld* const World = GetWorld();
+	if (!World || !GeoGameState) { return false; }
+
+	if (Snapshot.MapName != World->GetMapName())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Arena snapshot was taken on %s, can't restore it on %s"), *Snapshot.MapName, *World->GetMapName());
+		return false;
+	}
+	if (Snapshot.CurrentWave > WaveInfo.Num() || (WaveInfo.IsValidIndex(Snapshot.CurrentWave - 1) && WaveInfo[Snapshot.CurrentWave - 1].SpawnInfo.Num() != Snapshot.SpawnedOfType.Num()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Arena snapshot doesn't match the wave table of %s"), *GetName());
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	/** the spawner continues the wave of the snapshot  */
+	EnsureWaveResident(Snapshot.CurrentWave - 1);
+
+	/** classes are loaded already, so it's just a lookup  */
+	TArray<UClass*> Classes;
+	for (const FString& ClassPath : Snapshot.Classes)
+	{
+		Classes.Add(FSoftClassPath(ClassPath).TryLoadClass<AActor>());
+	}
+	auto GetClass = [&Classes](uint16 Index, UClass* BaseClass) -> UClass*
+	{
+		UClass* Class = Classes.IsValidIndex(Index) ? Classes[Index] : nullptr;
+		return Class && Class->IsChildOf(BaseClass) ? Class : nullptr;
+	};
+
+	/** clear the arena  */
+	GetWorldTimerManager().ClearTimer(SpawnTimerHandle);
+	GetWorldTimerManager().ClearTimer(WaveTimerHandle);
+	for (TActorIterator<AEnemyBase> It(World); It; ++It)
+	{
+		if (!It->IsNetProxy())
+		{
+			It->Destroy();
+		}
+	}
+	for (TActorIterator<AProjectile> It(World); It; ++It)
+	{
+		It->Destroy();
+	}
+
+	/** Geos first, projectiles need their shooters  */
+	TArray<AGeo*> Geos;
+	GetPlayerGeos(Geos);
+	for (int32 i = 0; i < Geos.Num() && i < Snapshot.Geos.Num(); i++)
+	{
+		const FGeoPawnSnapshot& GeoState = Snapshot.Geos[i];
+		Geos[i]->RestoreState(GeoState.Location, GeoState.Velocity, GeoState.Health, GeoState.Weapon);
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (const FGeoEnemySnapshot& EnemyState : Snapshot.Enemies)
+	{
+		UClass* EnemyClass = GetClass(EnemyState.ClassIndex, AEnemyBase::StaticClass());
+		if (!EnemyClass) { continue; }
+
+		SILLYGEO_LLM_SCOPE(Enemies);
+
+		AEnemyBase* Enemy = World->SpawnActor<AEnemyBase>(EnemyClass, FVector(EnemyState.Location, 0.f), FRotator(0.f, EnemyState.Yaw, 0.f), SpawnParams);
+		if (Enemy)
+		{
+			Enemy->RestoreState(EnemyState.Health, (EEnemyColor)EnemyState.Color, FVector(EnemyState.Velocity, 0.f));
+			Enemy->InitReferences(this, GeoGameState);
+		}
+	}
+
+	for (const FGeoProjectileSnapshot& ProjectileState : Snapshot.Projectiles)
+	{
+		UClass* ProjectileClass = GetClass(ProjectileState.ClassIndex, AProjectile::StaticClass());
+		if (!ProjectileClass) { continue; }
+
+		AGeo* Shooter = Geos.IsValidIndex(ProjectileState.OwnerIndex) ? Geos[ProjectileState.OwnerIndex] : nullptr;
+		const FTransform SpawnTransform(FRotator(0.f, ProjectileState.Yaw, 0.f), ProjectileState.Location);
+
+		SILLYGEO_LLM_SCOPE(Projectiles);
+		AProjectile* Projectile = World->SpawnActorDeferred<AProjectile>(ProjectileClass, SpawnTransform, Shooter, Shooter, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Projectile)
+		{
+			/** the same rule as AGeo::SpawnProjectile, remote shooters report their hits  */
+			const bool bDealsDamage = Shooter && Shooter->IsLocallyControlled();
+			Projectile->InitProjectile(ProjectileState.Weapon, ProjectileState.Color, ProjectileState.InheritedSpeed, bDealsDamage);
+			Projectile->FinishSpawning(SpawnTransform);
+		}
+	}
+
+	/** wave counters and spawn cursor  */
+	GeoGameState->SetCurrentWave(Snapshot.CurrentWave);
+	GeoGameState->SetWaveActive(Snapshot.bWaveActive);
+	GeoGameState->AddEnemiesRemaining(Snapshot.EnemiesRemaining - GeoGameState->GetEnemiesRemaining());
+
+	EnemyToSpawn = Snapshot.EnemyToSpawn;
+	EnemiesSpawned = Snapshot.EnemiesSpawned;
+	SpawnedOfType = Snapshot.SpawnedOfType;
+
+	/** the timers continue from where they were, zero rate would clear them */
+	if (Snapshot.SpawnTimerRemaining >= 0.f)
+	{
+		const float Interval = BeginSpawnPacing();
+		GetWorldTimerManager().SetTimer(SpawnTimerHandle, this, &ASillyGeoGameMode::SpawnEnemy, Interval, true, FMath::Max(FMath::Min(Snapshot.SpawnTimerRemaining, Interval), KINDA_SMALL_NUMBER));
+	}
+	if (Snapshot.WaveTimerRemaining >= 0.f)
+	{
+		GetWorldTimerManager().SetTimer(WaveTimerHandle, this, &ASillyGeoGameMode::BeginWave, FMath::Max(Snapshot.WaveTimerRemaining, KINDA_SMALL_NUMBER), false);
+	}
+
+	UpdateHUD();
+
+	UE_LOG(LogTemp, Log, TEXT("Arena snapshot restored in %.2f ms: wave %d, %d enemies, %d projectiles"),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0, Snapshot.CurrentWave, Snapshot.Enemies.Num(), Snapshot.Projectiles.Num());
+	return true;
+}
+
+void ASillyGeoGameMode::SetWaveTable(const TArray<FWaveInfo>& NewWaveInfo, float NewWaveDelay, float NewSpawnDelay)
+{
+	/** the new table replaces wave assets too  */
+	for (int32 i = 0; i < WaveStreaming.Num(); i++)
+	{
+		ReleaseWave(i);
+	}
+	WaveStreaming.Reset();
+	LoadedWaveAssets.Reset();
+	WaveAssets.Reset();
+
+	WaveInfo = NewWaveInfo;
+	WaveDelay = NewWaveDelay;
+	SpawnDelay = NewSpawnDelay;
+	UpdateWaveTotals();
+
+	/** the game state is initialized before InitGame  */
+	if (GeoGameState)
+	{
+		GeoGameState->SetMaxWaves(MaxWaves);
+		GeoGameState->SetWaveDelay(WaveDelay);
+	}
+}
+
+// -------------- W A V E   S T R E A M I N G --------------------------------
+
+void ASillyGeoGameMode::BuildWaveTableFromAssets()
+{
+	TArray<FWaveInfo> Waves;
+	LoadedWaveAssets.Reset();
+	for (const TSoftObjectPtr<UGeoWaveDataAsset>& WaveAsset : WaveAssets)
+	{
+		/** tiny, enemy classes inside are soft references  */
+		UGeoWaveDataAsset* LoadedAsset = WaveAsset.LoadSynchronous();
+		if (!LoadedAsset)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Can't load wave asset %s"), *WaveAsset.ToString());
+		}
+
+		FWaveInfo& Wave = Waves[Waves.AddDefaulted()];
+		if (LoadedAsset)
+		{
+			LoadedAsset->GetWaveInfo(Wave);
+		}
+		LoadedWaveAssets.Add(LoadedAsset);
+	}
+
+	WaveInfo = Waves;
+	UpdateWaveTotals();
+	WaveStreaming.Reset();
+	WaveStreaming.SetNum(WaveInfo.Num());
+
+	/** the game state is initialized before InitGame  */
+	if (GeoGameState)
+	{
+		GeoGameState->SetMaxWaves(MaxWaves);
+	}
+}
+
+void ASillyGeoGameMode::StreamWave(int32 WaveIndex)
+{
+	if (!WaveStreaming.IsValidIndex(WaveIndex) || WaveStreaming[WaveIndex].IsStreaming() || WaveStreaming[WaveIndex].bResident) { return; }
+
+	TArray<FSoftObjectPath> Classes;
+	if (LoadedWaveAssets[WaveIndex])
+	{
+		LoadedWaveAssets[WaveIndex]->GetEnemyClasses(Classes);
+	}
+	if (Classes.Num() == 0)
+	{
+		OnWaveClassesStreamed(WaveIndex);
+		return;
+	}
+
+	WaveStreaming[WaveIndex].ClassesHandle = StreamableManager.RequestAsyncLoad(Classes, FStreamableDelegate::CreateUObject(this, &ASillyGeoGameMode::OnWaveClassesStreamed, WaveIndex));
+}
+
+void ASillyGeoGameMode::OnWaveClassesStreamed(int32 WaveIndex)
+{
+	if (!WaveStreaming.IsValidIndex(WaveIndex) || WaveStreaming[WaveIndex].bResident) { return; }
+
+	if (LoadedWaveAssets[WaveIndex])
+	{
+		LoadedWaveAssets[WaveIndex]->GetWaveInfo(WaveInfo[WaveIndex]);
+	}
+
+	/** meshes, materials, emitters and sounds of the enemies  */
+	TArray<FSoftObjectPath> Content;
+	for (const FSpawnInfo& Info : WaveInfo[WaveIndex].SpawnInfo)
+	{
+		if (Info.EnemyTemplate)
+		{
+			Info.EnemyTemplate->GetDefaultObject<AEnemyBase>()->GetPreloadAssets(Content);
+		}
+	}
+	if (Content.Num() == 0)
+	{
+		OnWaveContentStreamed(WaveIndex);
+		return;
+	}
+
+	WaveStreaming[WaveIndex].ContentHandle = StreamableManager.RequestAsyncLoad(Content, FStreamableDelegate::CreateUObject(this, &ASillyGeoGameMode::OnWaveContentStreamed, WaveIndex));
+}
+
+void ASillyGeoGameMode::OnWaveContentStreamed(int32 WaveIndex)
+{
+	if (!WaveStreaming.IsValidIndex(WaveIndex)) { return; }
+
+	FWaveStreaming& Wave = WaveStreaming[WaveIndex];
+	Wave.bResident = true;
+	if (Wave.bWarmUpWhenResident)
+	{
+		Wave.bWarmUpWhenResident = false;
+		WarmUpWave(WaveIndex);
+	}
+}
+
+void ASillyGeoGameMode::EnsureWaveResident(int32 WaveIndex)
+{
+	if (!WaveStreaming.IsValidIndex(WaveIndex) || WaveStreaming[WaveIndex].bResident) { return; }
+
+	StreamWave(WaveIndex);
+
+	/** the rest was too short, the wave can't wait  */
+	TSharedPtr<FStreamableHandle> ClassesHandle = WaveStreaming[WaveIndex].ClassesHandle;
+	if (ClassesHandle.IsValid() && ClassesHandle->IsLoadingInProgress())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Wave %d begins before its enemies are streamed in, loading them now"), WaveIndex + 1);
+		ClassesHandle->WaitUntilComplete();
+	}
+
+	/** the delegate may be called on the next tick, but the templates are needed now */
+	if (LoadedWaveAssets[WaveIndex])
+	{
+		LoadedWaveAssets[WaveIndex]->GetWaveInfo(WaveInfo[WaveIndex]);
+	}
+}
+
+void ASillyGeoGameMode::ReleaseWave(int32 WaveIndex)
+{
+	if (!WaveStreaming.IsValidIndex(WaveIndex)) { return; }
+
+	FWaveStreaming& Wave = WaveStreaming[WaveIndex];
+	for (const TSharedPtr<FStreamableHandle>& Handle : { Wave.ClassesHandle, Wave.ContentHandle })
+	{
+		if (!Handle.IsValid()) { continue; }
+
+		if (Handle->IsLoadingInProgress())
+		{
+			Handle->CancelHandle();
+		}
+		else
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+	Wave = FWaveStreaming();
+
+	/** no hard references, the amounts stay for HasEnemiesToSpawn and arena snapshots */
+	TArray<UClass*> Classes;
+	for (FSpawnInfo& Info : WaveInfo[WaveIndex].SpawnInfo)
+	{
+		if (Info.EnemyTemplate)
+		{
+			Classes.AddUnique(Info.EnemyTemplate);
+		}
+		Info.EnemyTemplate = nullptr;
+	}
+
+	/** classes shared with another loaded wave stay  */
+	for (const FWaveInfo& OtherWave : WaveInfo)
+	{
+		for (const FSpawnInfo& Info : OtherWave.SpawnInfo)
+		{
+			Classes.Remove(Info.EnemyTemplate);
+		}
+	}
+	if (Classes.Num() == 0) { return; }
+
+	if (ReleasedClasses.Num() == 0)
+	{
+		ReleaseUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	}
+	for (UClass* EnemyClass : Classes)
+	{
+		if (GeoGameState)
+		{
+			GeoGameState->ReleaseEnemyArchetype(EnemyClass);
+		}
+		ReleasedClasses.Add(EnemyClass);
+	}
+}
+
+void ASillyGeoGameMode::OnPostGarbageCollect()
+{
+	if (ReleasedClasses.Num() == 0) { return; }
+
+	/** anything still loaded is referenced from somewhere else  */
+	FString StillLoaded;
+	int32 Unloaded = 0;
+	for (const TWeakObjectPtr<UClass>& EnemyClass : ReleasedClasses)
+	{
+		if (EnemyClass.IsValid())
+		{
+			StillLoaded += FString::Printf(TEXT(" %s"), *EnemyClass->GetName());
+		}
+		else
+		{
+			Unloaded++;
+		}
+	}
+
+	auto ToMB = [](uint64 Bytes) { return Bytes / (1024.f * 1024.f); };
+	const uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	UE_LOG(LogTemp, Log, TEXT("Released enemy classes: %d, unloaded by GC: %d, UsedPhysical %.2f MB -> %.2f MB (%+.2f MB)%s%s"),
+		ReleasedClasses.Num(), Unloaded,
+		ToMB(ReleaseUsedPhysical), ToMB(UsedPhysical), ToMB(UsedPhysical) - ToMB(ReleaseUsedPhysical),
+		StillLoaded.IsEmpty() ? TEXT("") : TEXT(", still loaded:"), *StillLoaded);
+
+	ReleasedClasses.Reset();
+}
+
+void ASillyGeoGameMode::UpdateWaveTotals()
 {
 	/** max waves update  */
 	MaxWaves = WaveInfo.Num();
@@ -249,6 +1305,12 @@ void ASillyGeoGameMode::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 			WaveInfo[i].MaxEnemiesThisWave = MaxEnemies;
 		}
 	}
+}
+
+#if WITH_EDITOR
+void ASillyGeoGameMode::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	UpdateWaveTotals();
 
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 }
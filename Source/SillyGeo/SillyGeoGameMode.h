@@ -4,6 +4,11 @@
 
 #include "SillyGeo.h"
 #include "GameFramework/GameMode.h"
+#include "GeoObjectChurn.h"
+#include "GeoTelemetry.h"
+#include "GeoSpawnDirector.h"
+#include "GeoBlastResolver.h"
+#include "Engine/StreamableManager.h"
 #include "SillyGeoGameMode.generated.h"
 
 /**
@@ -15,6 +20,10 @@ class SILLYGEO_API ASillyGeoGameMode : public AGameMode
 	GENERATED_BODY()
 	
 public:
+
+	ASillyGeoGameMode();
+
+	virtual void Tick(float DeltaSeconds) override;
 	
 	/** calls to update HUD for each valid PC in the Game  */
 	void UpdateHUD();
@@ -24,6 +33,22 @@ public:
 	*/
 	void EndWave();
 
+	/** [server] calls once per kill batch (a blast or a single hit): credits the killer,
+	*	updates enemies remaining and HUD and ends the wave if it was the last enemy.
+	*	Enemies are destroyed by the caller after this
+	*/
+	void OnEnemiesKilled(const TArray<class AEnemyBase*>& Killed, AController* Killer);
+
+	/** [server] damages enemies of Color around Location, with chain blasts of killed enemies,
+	*	and reports all kills as one batch
+	*/
+	void ResolveBlast(const FVector& Location, float Radius, float Damage, EEnemyColor Color, AController* Instigator);
+
+	/** adds default assets of Geo, its projectiles and all enemies of the wave table to OutAssets,
+	*	clients call it on the game mode defaults to preload the same assets
+	*/
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
 	/** calls by spawner to store its reference here */
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	void SetSpawnerReference(AEnemySpawner* SpawnerToSet);
@@ -34,12 +59,55 @@ public:
 
 	/** calls to obtain random player pawn as target to move to  */
 	UFUNCTION(BlueprintCallable, Category = "AAA")
-	class APawn* GetRandomPlayerPawn() const;
+	virtual class APawn* GetRandomPlayerPawn() const;
+
+	/** logs memory and per-frame cost of gameplay objects, used to compare
+	*	dedicated server runs with and without cosmetic stripping ( -KeepCosmetics )
+	*/
+	UFUNCTION(Exec, BlueprintCallable, Category = "AAA")
+	void ReportServerCost() const;
+
+	/** returns CRC of gameplay state (Geos, enemies, projectiles, wave counters) */
+	UFUNCTION(BlueprintCallable, Category = "AAA")
+	int32 ComputeStateHash() const;
+
+	/** writes combat state of the arena to Saved/Snapshots/<Name>.geosnap  */
+	UFUNCTION(Exec, BlueprintCallable, Category = "AAA")
+	void SaveArenaSnapshot(const FString& Name);
+
+	/** replaces combat state of the arena with the one saved by SaveArenaSnapshot ( -GeoSnapshot=Name ) */
+	UFUNCTION(Exec, BlueprintCallable, Category = "AAA")
+	void LoadArenaSnapshot(const FString& Name);
+
+	/** fills the snapshot with wave counters, spawn cursor, enemies, projectiles and Geos */
+	void CaptureArenaSnapshot(struct FGeoArenaSnapshot& OutSnapshot) const;
+
+	/** destroys live enemies and projectiles and recreates the state of the snapshot,
+	*	returns false if the snapshot was taken on another map or wave table
+	*/
+	bool RestoreArenaSnapshot(const struct FGeoArenaSnapshot& Snapshot);
+
+	/** returns steps per second of fixed step simulation  */
+	FORCEINLINE float GetFixedStepRate() const { return FixedStepRate; }
+
+	/** returns RNG seed of fixed step simulation  */
+	FORCEINLINE int32 GetSimulationSeed() const { return SimulationSeed; }
+
+	/** returns true if gameplay advances on fixed steps with seeded RNG  */
+	UFUNCTION(BlueprintCallable, Category = "AAA")
+	bool IsFixedStepSimulation() const { return bFixedStepActive; }
+
+	/** returns the telemetry stream of the match, nullptr if it isn't written */
+	FORCEINLINE FGeoTelemetry* GetTelemetry() const { return Telemetry.Get(); }
 	
 protected:
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Called after a successful login.  This is the first place 
 	*	it is safe to call replicated functions on the PlayerController.
 	*	Saves the player controller reference to PlayerControllerList
@@ -57,6 +125,9 @@ protected:
 	*/
 	virtual void StartMatch() override;
 
+	/** holds the match until default assets of Geo, enemies and projectiles are streamed in */
+	virtual bool ReadyToStartMatch_Implementation() override;
+
 	/**
 	Transition from InProgress to WaitingPostMatch. You can call this manually,
 	will also get called if ReadyToEndMatch returns true
@@ -76,9 +147,81 @@ protected:
 	/** calls to clear used early variables and start spawning */
 	void BeginSpawning();
 
+	/** starts the spawn director on the current wave when it paces spawns, returns the spawn timer interval */
+	float BeginSpawnPacing();
+
 	/** calls to spawn an enemy if needed  */
 	void SpawnEnemy();
 
+	/** pins the engine clock to fixed steps and seeds RNG, every Tick and timer then advances by FixedStepRate */
+	void BeginFixedStepSimulation();
+
+	/** restores the engine clock  */
+	void EndFixedStepSimulation();
+
+	/** logs combined state hash of all frames since fixed step simulation began  */
+	void LogStateHash() const;
+
+	/** logs used memory and its growth during the wave and since the previous wave */
+	void LogWaveMemory();
+
+	/** starts async streaming of default assets of Geo, its projectiles and all enemies of the wave table */
+	void PreloadAssets();
+
+	/** calls when all preloaded assets are streamed in  */
+	void OnAssetsPreloaded();
+
+	/** spawns a hidden copy of every enemy type of specified wave that hasn't been warmed up yet,
+	*	so their materials, emitters and sounds are initialized during the rest, not on first spawn
+	*/
+	void WarmUpWave(int32 WaveIndex);
+
+	/** calls when the rest before specified wave begins: streams its enemies in and warms them up */
+	void PrepareWave(int32 WaveIndex);
+
+	/** loads the wave data assets and builds WaveInfo out of them, enemy templates stay empty until streamed in */
+	void BuildWaveTableFromAssets();
+
+	/** starts async streaming of enemy classes of specified wave, and their default assets after that */
+	void StreamWave(int32 WaveIndex);
+
+	/** calls when enemy classes of specified wave are streamed in  */
+	void OnWaveClassesStreamed(int32 WaveIndex);
+
+	/** calls when default assets of enemies of specified wave are streamed in */
+	void OnWaveContentStreamed(int32 WaveIndex);
+
+	/** makes sure the enemy templates of specified wave are loaded, waits for streaming if needed */
+	void EnsureWaveResident(int32 WaveIndex);
+
+	/** lets the enemy classes and assets of specified wave go, classes no other loaded wave uses
+	*	are dropped from the replicated enemy archetypes too
+	*/
+	void ReleaseWave(int32 WaveIndex);
+
+	/** logs which classes released by ReleaseWave are unloaded by GC and memory since the release */
+	void OnPostGarbageCollect();
+
+	/** garbage collection policy: returns true to hold GC back this frame,
+	*	by default GC waits for the rest between waves unless combat lasts longer than MaxGCDeferTime
+	*/
+	virtual bool ShouldDeferGarbageCollection() const;
+
+	/** calls before Super::InitGame to run on fixed steps with seeded RNG */
+	void RequestFixedStepSimulation() { bFixedStepSimulation = true; }
+
+	/** replaces the wave table designed in the editor  */
+	void SetWaveTable(const TArray<struct FWaveInfo>& NewWaveInfo, float NewWaveDelay, float NewSpawnDelay);
+
+	/** calls to update MaxWaves and MaxEnemiesThisWave of every wave from the wave table */
+	void UpdateWaveTotals();
+
+	/** loads the snapshot specified by -GeoSnapshot=Name once the match has started */
+	void LoadStartupSnapshot();
+
+	/** returns Geos of all players in player controller order  */
+	void GetPlayerGeos(TArray<class AGeo*>& OutGeos) const;
+
 private:
 
 	// Editor code to make updating values in the editor cleaner
@@ -102,10 +245,22 @@ private:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	int32 MaxWaves;
 
-	/** determines how many waves will be spawned and what stuff will contain each wave */
+	/** determines how many waves will be spawned and what stuff will contain each wave,
+	*	kept for old maps: enemy classes of these waves are never streamed, use WaveAssets
+	*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	TArray<struct FWaveInfo> WaveInfo;
 
+	/** wave table as primary data assets, replaces WaveInfo if set: enemy classes of only
+	*	the current and the next wave are kept in memory
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	TArray<TSoftObjectPtr<class UGeoWaveDataAsset>> WaveAssets;
+
+	/** loaded wave data assets, one per WaveInfo  */
+	UPROPERTY(Transient)
+	TArray<class UGeoWaveDataAsset*> LoadedWaveAssets;
+
 	/**  the order number of enemy type to spawn */
 	int32 EnemyToSpawn;
 
@@ -130,4 +285,168 @@ private:
 	/** spawner reference  */
 	UPROPERTY(BlueprintReadOnly, Category = "Config", meta = (AllowPrivateAccess = "true"))
 	class AEnemySpawner* Spawner;
+
+	/** if true, standalone games advance on fixed steps with seeded RNG, so identical
+	*	inputs give identical state ( -GeoFixedStep )
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	bool bFixedStepSimulation = false;
+
+	/** steps per second of fixed step simulation  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	float FixedStepRate = 60.f;
+
+	/** RNG seed of fixed step simulation ( -GeoSeed=N ) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	int32 SimulationSeed = 0;
+
+	/** if true, the state hash of every frame is logged ( -GeoLogStateHash ), otherwise only the combined one */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	bool bLogFrameStateHash = false;
+
+	/** shows whether fixed step simulation is running  */
+	bool bFixedStepActive = false;
+
+	/** engine clock settings to restore  */
+	bool bPrevUseFixedTimeStep = false;
+	double PrevFixedDeltaTime = 0.0;
+
+	/** combined state hash of all simulated frames  */
+	uint32 StateHash = 0;
+
+	/** frames simulated with fixed steps  */
+	int32 StateHashFrames = 0;
+
+	/** arena snapshot to load when the match starts ( -GeoSnapshot=Name ) */
+	FString StartupSnapshot;
+
+	/** if true, GC is held back while a wave is active, so its hitches land in WaveDelay */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	bool bDeferGCDuringCombat = true;
+
+	/** the longest time (in sec) GC can be held back during a wave  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float MaxGCDeferTime = 30.f;
+
+	/** if true, incremental GC starts as soon as a wave ends  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	bool bForceGCBetweenWaves = true;
+
+	/** if true, UObjects created / destroyed per class and GC passes are logged every wave ( -GeoTrackChurn ) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	bool bTrackObjectChurn = false;
+
+	/** object churn of the current wave  */
+	TUniquePtr<FGeoObjectChurnTracker> ObjectChurn;
+
+	/** if true, waves, spawns, kills, damage and frame times are streamed to Saved/Telemetry ( -GeoTelemetry ) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	bool bWriteTelemetry = false;
+
+	/** telemetry stream of the match  */
+	TUniquePtr<FGeoTelemetry> Telemetry;
+
+	/** if true, spawn interval and alive enemies are paced by game thread time, off in fixed step simulation */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	bool bDirectSpawning = true;
+
+	/** game thread time (in ms) the spawn director keeps the average under  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	float SpawnTargetGameThreadMs = 10.f;
+
+	/** the longest spawn interval as a multiple of SpawnDelay  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	float MaxSpawnSlowdown = 4.f;
+
+	/** the spawn director never caps alive enemies below this amount  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Simulation", meta = (AllowPrivateAccess = "true"))
+	int32 MinAliveEnemiesCap = 10;
+
+	FGeoSpawnDirector SpawnDirector;
+
+	/** radius (in uu) of the blast of an enemy killed by an explosive weapon, 0 - no chain reactions */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gameplay", meta = (AllowPrivateAccess = "true"))
+	float ChainBlastRadius = 300.f;
+
+	/** damage of the blast of an enemy killed by an explosive weapon  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gameplay", meta = (AllowPrivateAccess = "true"))
+	float ChainBlastDamage = 50.f;
+
+	/** how many times chain blasts may cause next chain blasts  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gameplay", meta = (AllowPrivateAccess = "true"))
+	int32 MaxChainBlastDepth = 3;
+
+	FGeoBlastResolver BlastResolver;
+
+	/** enemies killed by the current blast batch  */
+	TArray<class AEnemyBase*> BlastKills;
+
+	/** net ids of the batch victims that die without own explosion on clients  */
+	TArray<int32> BlastQuietIds;
+
+	/** returns true if the spawn director paces this match  */
+	bool IsSpawnDirected() const { return bDirectSpawning && !bFixedStepActive; }
+
+	/** [tick] feeds the spawn director and re-arms the spawn timer if the interval changed */
+	void UpdateSpawnDirector();
+
+	/** game time the current wave began  */
+	float WaveStartTime = 0.f;
+
+	/** streams default assets in while the map loads  */
+	FStreamableManager StreamableManager;
+
+	/** keeps preloaded assets in memory  */
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** wall time the preload started and took (in sec)  */
+	double PreloadStartTime = 0.0;
+	double PreloadDuration = 0.0;
+
+	/** if true, enemy types of the next wave are warmed up during WaveDelay  */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	bool bWarmUpNextWave = true;
+
+	/** how far (in uu) in front of the first local camera warm-up copies are spawned, just past the near clip plane */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float WarmUpDistance = 20.f;
+
+	/** scale of warm-up copies, small enough to be a speck in front of the camera */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float WarmUpScale = 0.01f;
+
+	/** how long (in sec) warm-up copies live, one rendered frame is enough */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Config", meta = (AllowPrivateAccess = "true"))
+	float WarmUpLifeSpan = 0.05f;
+
+	/** the wave to warm up once a local player has a camera, INDEX_NONE - none */
+	int32 PendingWarmUpWave = INDEX_NONE;
+
+	/** enemy types warmed up already, weak, so released classes are warmed up again once they are back */
+	TArray<TWeakObjectPtr<UClass>> WarmedUpClasses;
+
+	/** streaming of one wave of WaveAssets  */
+	struct FWaveStreaming
+	{
+		TSharedPtr<FStreamableHandle> ClassesHandle;
+		TSharedPtr<FStreamableHandle> ContentHandle;
+
+		/** true once both enemy classes and their assets are loaded  */
+		bool bResident = false;
+
+		/** if true, the wave is warmed up as soon as it is resident  */
+		bool bWarmUpWhenResident = false;
+
+		bool IsStreaming() const { return (ClassesHandle.IsValid() || ContentHandle.IsValid()) && !bResident; }
+	};
+	TArray<FWaveStreaming> WaveStreaming;
+
+	/** enemy classes released since the last GC and used physical memory (bytes) before the first release */
+	TArray<TWeakObjectPtr<UClass>> ReleasedClasses;
+	uint64 ReleaseUsedPhysical = 0;
+	FDelegateHandle PostGCHandle;
+
+	/** used physical memory (bytes) when the current wave began and when the previous wave ended */
+	uint64 WaveStartUsedPhysical = 0;
+	uint64 LastWaveEndUsedPhysical = 0;
 };
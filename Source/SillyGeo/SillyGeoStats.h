@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/** SillyGeo replication stats, "stat SillyGeoNet" */
+DECLARE_STATS_GROUP(TEXT("SillyGeoNet"), STATGROUP_SillyGeoNet, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Replicated enemies"), STAT_ReplicatedEnemies, STATGROUP_SillyGeoNet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Dirty enemy entries"), STAT_DirtyEnemyEntries, STATGROUP_SillyGeoNet, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Enemy bytes per enemy per second per connection"), STAT_EnemyBytesPerEnemySecond, STATGROUP_SillyGeoNet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate hit"), STAT_ValidateHit, STATGROUP_SillyGeoNet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected hits"), STAT_RejectedHits, STATGROUP_SillyGeoNet, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Enemy bytes per connection per second"), STAT_EnemyBytesPerConnectionSecond, STATGROUP_SillyGeoNet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Relevant enemies (all connections)"), STAT_RelevantEnemies, STATGROUP_SillyGeoNet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interest update"), STAT_InterestUpdate, STATGROUP_SillyGeoNet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Skipped property compares per connection"), STAT_SkippedRepCompares, STATGROUP_SillyGeoNet, );
+
+/** SillyGeo gameplay stats, "stat SillyGeo" */
+DECLARE_STATS_GROUP(TEXT("SillyGeo"), STATGROUP_SillyGeo, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Geo Fire"), STAT_GeoFire, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Geo RotateToMouseCursor"), STAT_GeoRotateToMouseCursor, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Tracking"), STAT_EnemyTracking, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Follow"), STAT_EnemyFollow, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy TakeDamage"), STAT_EnemyTakeDamage, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile OnOverlapBegin"), STAT_ProjectileOverlap, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GameMode SpawnEnemy"), STAT_GameModeSpawnEnemy, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GameMode UpdateHUD"), STAT_GameModeUpdateHUD, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GameMode ResolveBlast"), STAT_GameModeResolveBlast, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawner SpawnEnemy"), STAT_SpawnerSpawnEnemy, STATGROUP_SillyGeo, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live enemies"), STAT_LiveEnemies, STATGROUP_SillyGeo, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live projectiles"), STAT_LiveProjectiles, STATGROUP_SillyGeo, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Live emitters"), STAT_LiveEmitters, STATGROUP_SillyGeo, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Spawn director interval (sec)"), STAT_SpawnDirectorInterval, STATGROUP_SillyGeo, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawn director alive cap"), STAT_SpawnDirectorAliveCap, STATGROUP_SillyGeo, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Spawn director game thread (ms)"), STAT_SpawnDirectorGameThreadMs, STATGROUP_SillyGeo, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Spawn director held spawns"), STAT_SpawnDirectorHeldSpawns, STATGROUP_SillyGeo, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Split-screen view groups"), STAT_SplitScreenViewGroups, STATGROUP_SillyGeo, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Split-screen low significance enemies"), STAT_SplitScreenLowSignificance, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Split-screen significance"), STAT_SplitScreenSignificance, STATGROUP_SillyGeo, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Indexed enemies"), STAT_IndexedEnemies, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy index update"), STAT_EnemyIndexUpdate, STATGROUP_SillyGeo, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy index query"), STAT_EnemyIndexQuery, STATGROUP_SillyGeo, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blast kills"), STAT_BlastKills, STATGROUP_SillyGeo, );
+
+/** the engine has no CSV profiler yet, so the gameplay scopes are also summed up per frame
+*	for the benchmark report. Compiled out in Shipping together with the stats
+*/
+#define SILLYGEO_FRAME_COUNTERS !UE_BUILD_SHIPPING
+
+#if SILLYGEO_FRAME_COUNTERS
+
+/** [game thread] time spent in gameplay scopes during the frame, nested scopes are inclusive */
+struct SILLYGEO_API FSillyGeoFrameCounters
+{
+	enum ECounter : uint8
+	{
+		GeoFire,
+		GeoRotateToMouseCursor,
+		EnemyTracking,
+		EnemyFollow,
+		EnemyTakeDamage,
+		ProjectileOverlap,
+		GameModeSpawnEnemy,
+		GameModeUpdateHUD,
+		GameModeResolveBlast,
+		SpawnerSpawnEnemy,
+		Num
+	};
+
+	/** the frame in progress  */
+	static uint64 Cycles[Num];
+
+	/** ms spent in every scope during the last finished frame  */
+	static float LastFrameMs[Num];
+
+	static const TCHAR* const Names[Num];
+
+	/** calls once at the end of every frame  */
+	static void EndFrame();
+};
+
+struct FSillyGeoScopeCounter
+{
+	explicit FSillyGeoScopeCounter(FSillyGeoFrameCounters::ECounter InCounter)
+		: Counter(InCounter)
+		, StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	~FSillyGeoScopeCounter()
+	{
+		FSillyGeoFrameCounters::Cycles[Counter] += FPlatformTime::Cycles64() - StartCycles;
+	}
+
+private:
+
+	FSillyGeoFrameCounters::ECounter Counter;
+	uint64 StartCycles;
+};
+
+/** cycle stat + frame counter of the same scope  */
+#define SILLYGEO_SCOPE_COUNTER(Stat, Counter) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	FSillyGeoScopeCounter PREPROCESSOR_JOIN(SillyGeoScopeCounter, __LINE__)(FSillyGeoFrameCounters::Counter)
+
+#else
+
+#define SILLYGEO_SCOPE_COUNTER(Stat, Counter) SCOPE_CYCLE_COUNTER(Stat)
+
+#endif
+
+/** gameplay events and live actors, counted in every build so hitch captures
+*	have the gameplay context even where stats are compiled out
+*/
+struct SILLYGEO_API FSillyGeoFrameEvents
+{
+	enum EEvent : uint8
+	{
+		EnemySpawned,
+		EnemyKilled,
+		ProjectileSpawned,
+		Num
+	};
+
+	/** the frame in progress  */
+	static int32 Counts[Num];
+
+	/** events of the last finished frame  */
+	static int32 LastFrame[Num];
+
+	static const TCHAR* const Names[Num];
+
+	/** live actors right now  */
+	static int32 LiveEnemies;
+	static int32 LiveProjectiles;
+
+	static void Add(EEvent Event) { Counts[Event]++; }
+
+	/** calls once at the end of every frame  */
+	static void EndFrame();
+};
+
+#define SILLYGEO_FRAME_EVENT(Event) FSillyGeoFrameEvents::Add(FSillyGeoFrameEvents::Event)
+
+/** SillyGeo memory categories of low level memory tracker ( -LLM, "stat LLMFULL" ) */
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+enum class ESillyGeoLLMTag : LLM_TAG_TYPE
+{
+	Enemies = (LLM_TAG_TYPE)ELLMTag::ProjectTagStart,
+	Projectiles,
+	FX,
+	DynamicMaterials,
+};
+
+/** calls once on module startup  */
+void RegisterSillyGeoLLMTags();
+
+#define SILLYGEO_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)ESillyGeoLLMTag::Tag)
+
+#else
+
+#define SILLYGEO_LLM_SCOPE(Tag)
+
+#endif